@@ -108,7 +108,11 @@ if(CONFIG_MM_UBSAN_TRAP_ON_ERROR)
 endif()
 
 if(CONFIG_MM_KASAN_ALL)
-  add_compile_options(-fsanitize=kernel-address)
+  if(CONFIG_MM_KASAN_SW_TAGS)
+    add_compile_options(-fsanitize=kernel-hwaddress)
+  else()
+    add_compile_options(-fsanitize=kernel-address)
+  endif()
 endif()
 
 if(CONFIG_ARCH_INSTRUMENT_ALL)
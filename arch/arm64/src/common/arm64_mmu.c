@@ -227,6 +227,12 @@ static uint64_t get_tcr(int el)
 
   tcr |= TCR_TG0_4K | TCR_SHARED_INNER | TCR_ORGN_WBWA | TCR_IRGN_WBWA;
 
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+  /* Ignore the top byte of addresses, which holds the KASan tag */
+
+  tcr |= el == 1 ? TCR_EL1_TBI0 : TCR_EL3_TBI;
+#endif
+
   return tcr;
 }
 
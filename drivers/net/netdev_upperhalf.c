@@ -37,6 +37,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -73,6 +74,14 @@ struct netdev_upperhalf_s
 #else
   struct work_s work;
 #endif
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The TCP segment being coalesced in the current receive batch */
+
+  FAR netpkt_t *gro;
+  uint8_t gro_iplen;   /* Length of its IP header */
+  uint8_t gro_hdrlen;  /* Length of its IP and TCP headers */
+#endif
 };
 
 /****************************************************************************
@@ -227,6 +236,270 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return netdev_lower_quota_load(upper->lower, NETPKT_TX) > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_seq
+ *
+ * Description:
+ *   Get the host order value of a TCP sequence number field.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_GRO) || defined(CONFIG_NET_TCP_GSO)
+static inline uint32_t netdev_upper_seq(FAR const uint8_t *seqno)
+{
+  return (uint32_t)seqno[0] << 24 | (uint32_t)seqno[1] << 16 |
+         (uint32_t)seqno[2] << 8 | seqno[3];
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_GSO
+/****************************************************************************
+ * Name: netdev_upper_gso_budget
+ *
+ * Description:
+ *   Tell the TCP layer how many segments it may pack into one packet.  The
+ *   software segmentation needs one TX quota per segment in addition to
+ *   the one held by the original packet, hardware TSO needs only one.
+ *   The budget is redone after every packet sent, so that a packet built
+ *   later in the same poll never has more segments than the quota left.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gso_budget(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  int                            quota;
+
+  dev->d_gso_size = 0;
+
+  if (lower->ops->transmit_tso != NULL)
+    {
+      dev->d_gso_maxsegs = UINT16_MAX;
+      return;
+    }
+
+  quota = netdev_lower_quota_load(lower, NETPKT_TX) - 1;
+  dev->d_gso_maxsegs = quota > 1 ? MIN(quota, UINT16_MAX) : 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_segment
+ *
+ * Description:
+ *   Software segmentation of a TCP packet larger than the MTU.  Every
+ *   segment gets a copy of the link, IP and TCP headers followed by up to
+ *   'mss' bytes of the payload, with the length, IP identification,
+ *   sequence number, flags and checksums fixed up.  FIN and PSH are only
+ *   kept on the last segment.  The payload is checksummed while it is
+ *   copied.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The oversized packet, always consumed
+ *   mss   - The payload size of the segments
+ *
+ * Returned Value:
+ *   OK if all segments were handed to the driver, otherwise a negated
+ *   errno value; TCP retransmits whatever was lost.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_segment(FAR struct netdev_upperhalf_s *upper,
+                                    FAR netpkt_t *pkt, uint16_t mss)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s *dev = &lower->netdev;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+  FAR netpkt_t *seg;
+  FAR netpkt_t *src;
+  FAR uint8_t *segip;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int addroff;
+  unsigned int addrlen;
+  unsigned int iplen;
+  unsigned int hdrlen;
+  unsigned int paylen;
+  unsigned int seglen;
+  unsigned int srcoff;
+  unsigned int ncopy;
+  unsigned int off;
+  uint32_t seq;
+#ifdef CONFIG_NET_IPv4
+  uint16_t ipid = 0;
+#endif
+  uint16_t sum;
+  uint8_t flags;
+  int ret = -EINVAL;
+
+#ifdef CONFIG_NET_IPv4
+  if (ip[0] == 0x45 && ((FAR struct ipv4_hdr_s *)ip)->proto == IP_PROTO_TCP)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      iplen   = IPv4_HDRLEN;
+      addroff = (FAR uint8_t *)ipv4->srcipaddr - ip;
+      addrlen = 2 * sizeof(in_addr_t);
+      ipid    = ipv4->ipid[0] << 8 | ipv4->ipid[1];
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION &&
+      ((FAR struct ipv6_hdr_s *)ip)->proto == IP_PROTO_TCP)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      iplen   = IPv6_HDRLEN;
+      addroff = (FAR uint8_t *)ipv6->srcipaddr - ip;
+      addrlen = 2 * sizeof(net_ipv6addr_t);
+    }
+  else
+#endif
+    {
+      goto out;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + iplen);
+  hdrlen = iplen + ((tcp->tcpoffset >> 4) << 2);
+  if (pkt->io_len < hdrlen || pkt->io_pktlen <= hdrlen)
+    {
+      goto out;
+    }
+
+  paylen = pkt->io_pktlen - hdrlen;
+  seq    = netdev_upper_seq(tcp->seqno);
+  flags  = tcp->flags;
+
+  /* Position of the payload within the chain of the original packet */
+
+  src    = pkt;
+  srcoff = hdrlen;
+  while (srcoff >= src->io_len && src->io_flink != NULL)
+    {
+      srcoff -= src->io_len;
+      src     = src->io_flink;
+    }
+
+  for (off = 0; off < paylen; off += seglen)
+    {
+      seglen = MIN(mss, paylen - off);
+
+      seg = netpkt_alloc(lower, NETPKT_TX);
+      if (seg == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+
+      /* Copy the headers (the link layer header lives in front of the IP
+       * header) and fix them up for this segment.
+       */
+
+      ret = netpkt_copyin(lower, seg, ip - llhdrlen, llhdrlen + hdrlen, 0);
+      if (ret < 0)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          goto out;
+        }
+
+      segip = IOB_DATA(seg);
+      tcp   = (FAR struct tcp_hdr_s *)(segip + iplen);
+
+#ifdef CONFIG_NET_IPv4
+      if (iplen == IPv4_HDRLEN)
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)segip;
+
+          ipv4->len[0]    = (hdrlen + seglen) >> 8;
+          ipv4->len[1]    = (hdrlen + seglen) & 0xff;
+          ipv4->ipid[0]   = ipid >> 8;
+          ipv4->ipid[1]   = ipid & 0xff;
+          ipv4->ipchksum  = 0;
+          ipv4->ipchksum  = ~ipv4_chksum(ipv4);
+          ipid++;
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (iplen == IPv6_HDRLEN)
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)segip;
+
+          ipv6->len[0] = (hdrlen - iplen + seglen) >> 8;
+          ipv6->len[1] = (hdrlen - iplen + seglen) & 0xff;
+        }
+#endif
+
+      tcp->seqno[0]  = (seq + off) >> 24;
+      tcp->seqno[1]  = (seq + off) >> 16;
+      tcp->seqno[2]  = (seq + off) >> 8;
+      tcp->seqno[3]  = (seq + off);
+      tcp->flags     = off + seglen < paylen ?
+                       flags & ~(TCP_FIN | TCP_PSH) : flags;
+      tcp->tcpchksum = 0;
+
+      /* Sum the pseudo and TCP headers, then copy the payload of this
+       * segment and sum it in the same pass.
+       */
+
+      sum = hdrlen - iplen + seglen + IP_PROTO_TCP;
+      sum = chksum(sum, segip + addroff, addrlen);
+      sum = chksum(sum, segip + iplen, hdrlen - iplen);
+
+      for (ncopy = 0; ret >= 0 && ncopy < seglen; )
+        {
+          unsigned int chunk = MIN(seglen - ncopy, src->io_len - srcoff);
+
+          if (chunk == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = chksum_iob_copyin(seg, IOB_DATA(src) + srcoff, chunk,
+                                  hdrlen + ncopy, &sum);
+          ncopy  += chunk;
+          srcoff += chunk;
+          if (srcoff >= src->io_len && src->io_flink != NULL)
+            {
+              src    = src->io_flink;
+              srcoff = 0;
+            }
+        }
+
+      if (ret < 0)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          goto out;
+        }
+
+      tcp->tcpchksum = ~(sum == 0 ? 0xffff : HTONS(sum));
+
+      ret = lower->ops->transmit(lower, seg);
+      if (ret != OK)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          goto out;
+        }
+    }
+
+out:
+  netpkt_free(lower, pkt, NETPKT_TX);
+  return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -258,6 +531,9 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
   int                            ret;
+#ifdef CONFIG_NET_TCP_GSO
+  uint16_t                       gso_size;
+#endif
 
   DEBUGASSERT(dev->d_len > 0);
 
@@ -269,12 +545,43 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+  gso_size = dev->d_gso_size;
+  dev->d_gso_size = 0;
+#endif
+
   pkt = netpkt_get(dev, NETPKT_TX);
 
   if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
     {
-      nerr("ERROR: Packet too long to send!\n");
-      ret = -EMSGSIZE;
+#ifdef CONFIG_NET_TCP_GSO
+      if (gso_size != 0)
+        {
+          if (lower->ops->transmit_tso != NULL)
+            {
+              ret = lower->ops->transmit_tso(lower, pkt, gso_size);
+            }
+          else
+            {
+              /* The segments are sent and the packet is freed in any
+               * case, there is nothing left to recycle.
+               */
+
+              if (netdev_upper_gso_segment(upper, pkt, gso_size) < 0)
+                {
+                  NETDEV_TXERRORS(dev);
+                }
+
+              netdev_upper_gso_budget(upper);
+              return NETDEV_TX_CONTINUE;
+            }
+        }
+      else
+#endif
+        {
+          nerr("ERROR: Packet too long to send!\n");
+          ret = -EMSGSIZE;
+        }
     }
   else
     {
@@ -292,6 +599,12 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
       return ret;
     }
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* The packet took TX quota, the next one must not count on it */
+
+  netdev_upper_gso_budget(upper);
+#endif
+
   return NETDEV_TX_CONTINUE;
 }
 
@@ -318,8 +631,16 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
   if (IFF_IS_UP(dev->d_flags))
     {
       DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
-      while (netdev_upper_can_tx(upper) &&
-             devif_poll(dev, netdev_upper_txpoll) == NETDEV_TX_CONTINUE);
+      while (netdev_upper_can_tx(upper))
+        {
+#ifdef CONFIG_NET_TCP_GSO
+          netdev_upper_gso_budget(upper);
+#endif
+          if (devif_poll(dev, netdev_upper_txpoll) != NETDEV_TX_CONTINUE)
+            {
+              break;
+            }
+        }
     }
 }
 
@@ -405,6 +726,355 @@ static void eth_input(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Function: netdev_upper_input
+ *
+ * Description:
+ *   Pass one received packet into the network stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+
+#ifdef CONFIG_NET_TCP_GSO
+  /* A reply to this packet may carry several segments of data */
+
+  netdev_upper_gso_budget(upper);
+#endif
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_gro_*
+ *
+ * Description:
+ *   Generic receive offload.  Consecutive in-order TCP segments of the same
+ *   flow within one receive batch are coalesced into the first one, which
+ *   is held in upper->gro until a segment of another flow arrives, the
+ *   PSH flag is seen, the size limit is reached or the batch ends.
+ *
+ *   The TCP checksum of the coalesced segment is derived from the headers
+ *   only, such that it verifies if and only if the checksums of all
+ *   coalesced segments did.  The payload is neither touched nor copied.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static inline uint16_t netdev_upper_csum_add(uint16_t sum, uint16_t val)
+{
+  sum += val;
+  return sum < val ? sum + 1 : sum;
+}
+
+static FAR struct tcp_hdr_s *
+netdev_upper_gro_parse(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
+                       FAR unsigned int *iplen, FAR unsigned int *hdrlen)
+{
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)(ip - ETH_HDRLEN);
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int tcplen;
+
+  if (NET_LL_HDRLEN(dev) != ETH_HDRLEN)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      /* Only unfragmented packets without IP options for this host */
+
+      if (pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN ||
+          ipv4->vhl != 0x45 || ipv4->proto != IP_PROTO_TCP ||
+          !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                            dev->d_ipaddr) ||
+          ((ipv4->ipoffset[0] << 8 | ipv4->ipoffset[1]) &
+           ~IP_FLAG_DONTFRAG) != 0 ||
+          (ipv4->len[0] << 8 | ipv4->len[1]) != pkt->io_pktlen ||
+          chksum(0, ip, IPv4_HDRLEN) != 0xffff)
+        {
+          return NULL;
+        }
+
+      *iplen = IPv4_HDRLEN;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      /* Only packets without extension headers for this host */
+
+      if (pkt->io_len < IPv6_HDRLEN + TCP_HDRLEN ||
+          ipv6->proto != IP_PROTO_TCP ||
+          !NETDEV_IS_MY_V6ADDR(dev, ipv6->destipaddr) ||
+          (ipv6->len[0] << 8 | ipv6->len[1]) + IPv6_HDRLEN !=
+          pkt->io_pktlen)
+        {
+          return NULL;
+        }
+
+      *iplen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      return NULL;
+    }
+
+  /* Only data segments with no other flags than ACK and PSH */
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + *iplen);
+  tcplen = (tcp->tcpoffset >> 4) << 2;
+
+  if (tcplen < TCP_HDRLEN || pkt->io_len < *iplen + tcplen ||
+      pkt->io_pktlen <= *iplen + tcplen ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return NULL;
+    }
+
+  *hdrlen = *iplen + tcplen;
+  return tcp;
+}
+
+static bool netdev_upper_gro_match(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   unsigned int iplen, unsigned int hdrlen)
+{
+  FAR netpkt_t *held = upper->gro;
+  FAR uint8_t *ip1 = IOB_DATA(held);
+  FAR uint8_t *ip2 = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp1 = (FAR struct tcp_hdr_s *)(ip1 + iplen);
+  unsigned int paylen = held->io_pktlen - hdrlen;
+
+  if (upper->gro_iplen != iplen || upper->gro_hdrlen != hdrlen ||
+      (tcp1->flags & TCP_PSH) != 0 || (paylen & 1) != 0 ||
+      paylen + pkt->io_pktlen - hdrlen > CONFIG_NETDEV_GRO_MAXSIZE)
+    {
+      return false;
+    }
+
+  /* The link layer headers must be the same */
+
+  if (memcmp(ip1 - ETH_HDRLEN, ip2 - ETH_HDRLEN, ETH_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  /* The IP headers may only differ in length, ID and checksum */
+
+#ifdef CONFIG_NET_IPv4
+  if (iplen == IPv4_HDRLEN &&
+      (memcmp(ip1, ip2, 2) != 0 || memcmp(ip1 + 8, ip2 + 8, 2) != 0 ||
+       memcmp(ip1 + 12, ip2 + 12, 8) != 0))
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (iplen == IPv6_HDRLEN &&
+      (memcmp(ip1, ip2, 4) != 0 ||
+       memcmp(ip1 + 6, ip2 + 6, IPv6_HDRLEN - 6) != 0))
+    {
+      return false;
+    }
+#endif
+
+  /* The TCP headers may only differ in sequence number, PSH flag and
+   * checksum, and the segment must follow the held one.
+   */
+
+  return memcmp(tcp1, tcp, 4) == 0 &&
+         memcmp(tcp1->ackno, tcp->ackno, 6) == 0 &&
+         memcmp(tcp1->optdata, tcp->optdata, hdrlen - iplen - TCP_HDRLEN)
+           == 0 &&
+         netdev_upper_seq(tcp1->seqno) + paylen ==
+         netdev_upper_seq(tcp->seqno);
+}
+
+static void netdev_upper_gro_merge(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct tcp_hdr_s *tcp)
+{
+  FAR netpkt_t *held = upper->gro;
+  FAR uint8_t *ip1 = IOB_DATA(held);
+  FAR struct tcp_hdr_s *tcp1 =
+    (FAR struct tcp_hdr_s *)(ip1 + upper->gro_iplen);
+  unsigned int tcplen = upper->gro_hdrlen - upper->gro_iplen;
+  unsigned int paylen = pkt->io_pktlen - upper->gro_hdrlen;
+  unsigned int len;
+  uint16_t sum;
+
+  /* With the pseudo header sums P, the full header sums H (checksum field
+   * included) and the payload sums D, a segment verifies if P + H + D is
+   * 0xffff.  Choose the new checksum so that P + H + D of the merged
+   * segment equals the sum of the two segments, which needs:
+   *
+   *   chksum = P1 + P2 - P + H1 + H2 - H(without chksum)
+   *
+   * where P1 + P2 - P reduces to the addresses, the protocol and the TCP
+   * header length.
+   */
+
+  sum = chksum(0, (FAR uint8_t *)tcp1, tcplen);
+  sum = chksum(sum, (FAR uint8_t *)tcp, tcplen);
+#ifdef CONFIG_NET_IPv4
+  if (upper->gro_iplen == IPv4_HDRLEN)
+    {
+      sum = chksum(sum, ip1 + 12, 8);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (upper->gro_iplen == IPv6_HDRLEN)
+    {
+      sum = chksum(sum, ip1 + 8, 32);
+    }
+#endif
+
+  sum = netdev_upper_csum_add(sum, IP_PROTO_TCP);
+  sum = netdev_upper_csum_add(sum, tcplen);
+
+  tcp1->flags    |= tcp->flags & TCP_PSH;
+  tcp1->tcpchksum = 0;
+  sum = netdev_upper_csum_add(sum,
+                              ~chksum(0, (FAR uint8_t *)tcp1, tcplen));
+  tcp1->tcpchksum = HTONS(sum);
+
+  /* Update the IP length (and header checksum) */
+
+#ifdef CONFIG_NET_IPv4
+  if (upper->gro_iplen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip1;
+
+      len = held->io_pktlen + paylen;
+      ipv4->len[0]   = len >> 8;
+      ipv4->len[1]   = len & 0xff;
+      ipv4->ipchksum = 0;
+      sum = chksum(0, ip1, IPv4_HDRLEN);
+      ipv4->ipchksum = ~HTONS(sum == 0 ? 0xffff : sum);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (upper->gro_iplen == IPv6_HDRLEN)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip1;
+
+      len = held->io_pktlen + paylen - IPv6_HDRLEN;
+      ipv6->len[0] = len >> 8;
+      ipv6->len[1] = len & 0xff;
+    }
+#endif
+
+  /* Append the payload.  The packet now belongs to the network stack. */
+
+  pkt = iob_trimhead(pkt, upper->gro_hdrlen);
+  iob_concat(held, pkt);
+  quota_fetch_inc(upper->lower, NETPKT_RX);
+}
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *held = upper->gro;
+
+  if (held != NULL)
+    {
+      upper->gro = NULL;
+      netdev_upper_input(upper, held);
+    }
+}
+
+static FAR netpkt_t *netdev_upper_gro(FAR struct netdev_upperhalf_s *upper,
+                                      FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iplen;
+  unsigned int hdrlen;
+
+  tcp = netdev_upper_gro_parse(dev, pkt, &iplen, &hdrlen);
+  if (tcp == NULL)
+    {
+      /* Not a candidate, keep the order with the held segment */
+
+      netdev_upper_gro_flush(upper);
+      return pkt;
+    }
+
+  if (upper->gro != NULL &&
+      netdev_upper_gro_match(upper, pkt, tcp, iplen, hdrlen))
+    {
+      netdev_upper_gro_merge(upper, pkt, tcp);
+      return NULL;
+    }
+
+  /* Start coalescing with this segment */
+
+  netdev_upper_gro_flush(upper);
+  upper->gro        = pkt;
+  upper->gro_iplen  = iplen;
+  upper->gro_hdrlen = hdrlen;
+  return NULL;
+}
+#endif /* CONFIG_NETDEV_GRO */
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
@@ -441,41 +1111,22 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           continue;
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
+#ifdef CONFIG_NETDEV_GRO
+      pkt = netdev_upper_gro(upper, pkt);
+      if (pkt == NULL)
+        {
+          continue;
+        }
+#endif
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+      netdev_upper_input(upper, pkt);
+    }
 
-      pkt_input(dev);
-#endif
+#ifdef CONFIG_NETDEV_GRO
+  /* Hand the last coalesced segment of the batch to the stack */
 
-      switch (dev->d_lltype)
-        {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+  netdev_upper_gro_flush(upper);
 #endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
-    }
 }
 
 /****************************************************************************
@@ -986,6 +1637,9 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
 #endif
   dev->netdev.d_private = upper;
+#ifdef CONFIG_NET_TCP_GSO
+  dev->netdev.d_gso_maxsize = CONFIG_NET_TCP_GSO_MAXSIZE;
+#endif
 
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
@@ -1171,7 +1825,10 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
       return NULL;
     }
 
-  pkt = iob_tryalloc(false);
+  /* Prefer a buffer that holds a whole packet, see CONFIG_IOB_POOLS */
+
+  pkt = iob_tryalloc_len(false, NETDEV_PKTSIZE(&dev->netdev) +
+                                CONFIG_NET_LL_GUARDSIZE);
   if (pkt == NULL)
     {
       quota_fetch_inc(dev, type);
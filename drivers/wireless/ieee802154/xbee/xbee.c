@@ -202,7 +202,7 @@ static void xbee_attnworker(FAR void *arg)
     {
       while (priv->lower->poll(priv->lower) && iob != NULL)
         {
-          DEBUGASSERT(iob->io_len <= CONFIG_IOB_BUFSIZE);
+          DEBUGASSERT(iob->io_len <= IOB_BUFSIZE(iob));
 
           SPI_RECVBLOCK(priv->spi, &iob->io_data[iob->io_len], 1);
 
@@ -1349,7 +1349,7 @@ void xbee_send_apiframe(FAR struct xbee_priv_s *priv,
 
       if (priv->attn_latched && iob != NULL)
         {
-          DEBUGASSERT(iob->io_len <= CONFIG_IOB_BUFSIZE);
+          DEBUGASSERT(iob->io_len <= IOB_BUFSIZE(iob));
 
           switch (iob->io_len)
             {
@@ -182,6 +182,9 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
                                 FAR off_t *offset, int cpu)
 {
   struct timespec maxtime;
+#ifdef CONFIG_SMP
+  struct timespec totaltime;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -237,12 +240,69 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
 
   /* Generate output for maximum time in a critical section */
 
+#ifdef CONFIG_SMP
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "%lu.%09lu,",
+                             (unsigned long)maxtime.tv_sec,
+                             (unsigned long)maxtime.tv_nsec);
+#else
   linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "%lu.%09lu\n",
                              (unsigned long)maxtime.tv_sec,
                              (unsigned long)maxtime.tv_nsec);
+#endif
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  totalsize += copysize;
+
+#ifdef CONFIG_SMP
+  buffer    += copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Convert the maximum and the total time waiting to enter a critical
+   * section while another CPU held it.
+   */
+
+  if (g_crit_wait_max[cpu] > 0)
+    {
+      perf_convert(g_crit_wait_max[cpu], &maxtime);
+    }
+  else
+    {
+      maxtime.tv_sec = 0;
+      maxtime.tv_nsec = 0;
+    }
+
+  if (g_crit_wait_total[cpu] > 0)
+    {
+      perf_convert(g_crit_wait_total[cpu], &totaltime);
+    }
+  else
+    {
+      totaltime.tv_sec = 0;
+      totaltime.tv_nsec = 0;
+    }
+
+  /* Reset the maximum and the total */
+
+  g_crit_wait_max[cpu] = 0;
+  g_crit_wait_total[cpu] = 0;
+
+  /* Generate output for the time waiting to enter a critical section */
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "%lu.%09lu,%lu.%09lu\n",
+                             (unsigned long)maxtime.tv_sec,
+                             (unsigned long)maxtime.tv_nsec,
+                             (unsigned long)totaltime.tv_sec,
+                             (unsigned long)totaltime.tv_nsec);
   copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
 
   totalsize += copysize;
+#endif
+
   return totalsize;
 }
 
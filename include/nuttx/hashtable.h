@@ -59,6 +59,9 @@
 #define hashtable_add(table, item, key) \
   dq_addfirst(item, &table[HASH(key, hashtable_bits(table))])
 
+#define hashtable_addlast(table, item, key) \
+  dq_addlast(item, &table[HASH(key, hashtable_bits(table))])
+
 #define hashtable_delete(table, item, key) \
   dq_rem(item, &table[HASH(key, hashtable_bits(table))])
 
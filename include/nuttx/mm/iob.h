@@ -78,8 +78,14 @@
 
 /* IOB helpers */
 
+#ifdef CONFIG_IOB_POOLS
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -105,7 +111,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && !defined(CONFIG_IOB_POOLS)
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -114,7 +120,13 @@ struct iob_s
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
+#ifdef CONFIG_IOB_POOLS
+  uint16_t io_bufsize;  /* Size of the data buffer */
+  uint8_t  io_pool;     /* Pool of the I/O buffer, 0 is the default pool */
+  FAR uint8_t *io_data; /* Data buffer of the pool's size */
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -203,6 +215,21 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_len/iob_tryalloc_len
+ *
+ * Description:
+ *   Allocate an I/O buffer that should hold 'len' bytes.  With
+ *   CONFIG_IOB_POOLS, the buffer comes from the pool with the smallest
+ *   buffers of at least 'len' bytes that has a free buffer.  Otherwise, and
+ *   if all of those pools are empty, this is the same as iob_alloc() or
+ *   iob_tryalloc() and a chain may be needed to hold 'len' bytes.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_len(bool throttled, unsigned int len);
+FAR struct iob_s *iob_tryalloc_len(bool throttled, unsigned int len);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -88,6 +88,17 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+/* Free blocks of a mempool cached by one CPU, linked through the blocks */
+
+struct mempool_cache_s
+{
+  spinlock_t        lock;  /* Taken by the owner CPU or a flush */
+  FAR sq_entry_t   *head;  /* The cached free blocks */
+  size_t            count; /* The number of cached free blocks */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -114,6 +125,12 @@ struct mempool_s
 #endif
   spinlock_t lock;      /* The protect lock to mempool */
   sem_t      waitsem;   /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  struct mempool_cache_s cache[CONFIG_SMP_NCPUS]; /* The per-CPU caches */
+#  ifdef CONFIG_MM_PRESSURE
+  struct mm_shrinker_s shrinker; /* Flushes the caches for mm_shrink() */
+#  endif
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -139,12 +139,35 @@
 #define MM_DUMP_LEAK(dump, pid) \
     ((dump) == PID_MM_LEAK && (pid) >= 0 && nxsched_get_tcb(pid) == NULL)
 
+/* Memory pressure levels, see mm_pressure() */
+
+#define MM_PRESSURE_NONE     0
+#define MM_PRESSURE_LOW      1
+#define MM_PRESSURE_CRITICAL 2
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct mm_heap_s; /* Forward reference */
 
+#ifdef CONFIG_MM_PRESSURE
+/* A shrinker returns cached memory to the heaps when they run short.  The
+ * callback gets the pressure level and returns the number of bytes it
+ * freed or made available to a retried allocation, 0 once it has nothing
+ * left to give.  It runs in the context of a failing allocation, so it
+ * must not sleep on locks that may be held across an allocation (use the
+ * trylock variants).
+ */
+
+struct mm_shrinker_s
+{
+  FAR struct mm_shrinker_s *flink;
+  CODE size_t (*shrink)(FAR void *arg, int level);
+  FAR void *arg;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -208,6 +231,9 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
 void mm_uninitialize(FAR struct mm_heap_s *heap);
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable);
+#endif
 
 /* Functions contained in umm_initialize.c **********************************/
 
@@ -371,6 +397,17 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 void mm_memdump(FAR struct mm_heap_s *heap,
                 FAR const struct mm_memdump_s *dump);
 
+/* Functions contained in mm_pressure.c *************************************/
+
+#ifdef CONFIG_MM_PRESSURE
+void mm_set_watermarks(FAR struct mm_heap_s *heap, size_t low,
+                       size_t critical);
+int mm_pressure(FAR struct mm_heap_s *heap);
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker);
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker);
+size_t mm_shrink(int level);
+#endif
+
 #ifdef CONFIG_DEBUG_MM
 /* Functions contained in mm_checkcorruption.c ******************************/
 
@@ -204,6 +204,12 @@ struct socket_conn_s
   FAR struct devif_callback_s *list;
   FAR struct devif_callback_s *list_tail;
 
+  /* Per-connection lock, see conn_lock().  Initialized and destroyed by
+   * the alloc and free functions of every protocol.
+   */
+
+  rmutex_t      s_lock;
+
   /* Socket options */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -324,6 +330,17 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * Finer grained locks are layered below the network lock.  They must
+ * always be taken in this order:
+ *
+ *   net_lock()          - The whole network (compatibility lock)
+ *   conn_lock()         - One connection
+ *   net_table_rdlock()  - The routing, ARP and neighbor tables (leaf lock:
+ *   net_table_wrlock()    nothing else may be taken while holding it)
+ *
+ * None of the finer grained locks may be held across net_sem_wait() and
+ * its variants, because those momentarily release the network lock only.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -378,6 +395,41 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: conn_lock and conn_unlock
+ *
+ * Description:
+ *   Take or release the lock of one connection.  The lock is re-entrant.
+ *   For UDP and TCP it protects the read-ahead buffer of the connection,
+ *   so that data that is already buffered can be received without taking
+ *   the network lock.
+ *
+ * Input Parameters:
+ *   sconn - The connection to lock
+ *
+ * Returned Value:
+ *   conn_lock() returns zero (OK) on success; a negated errno value is
+ *   returned on failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+int conn_lock(FAR struct socket_conn_s *sconn);
+void conn_unlock(FAR struct socket_conn_s *sconn);
+
+/****************************************************************************
+ * Name: net_table_rdlock, net_table_wrlock and their unlock functions
+ *
+ * Description:
+ *   Lock the routing, ARP and neighbor tables for reading or for writing.
+ *   Any number of readers may hold the lock at the same time.
+ *
+ ****************************************************************************/
+
+void net_table_rdlock(void);
+void net_table_rdunlock(void);
+void net_table_wrlock(void);
+void net_table_wrunlock(void);
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -427,6 +427,20 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* TCP segmentation offload.  d_gso_maxsize and d_gso_maxsegs are the
+   * largest IP packet and the most segments the driver currently accepts
+   * for segmentation (zero disables offload).  d_gso_size is non-zero when
+   * the packet in d_iob is a TCP segment larger than the MTU that must be
+   * split into d_gso_size payloads; its TCP checksum is left for the
+   * segmentation logic to fill in.
+   */
+
+  uint16_t d_gso_maxsize;
+  uint16_t d_gso_maxsegs;
+  uint16_t d_gso_size;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -763,6 +777,29 @@ void netdev_carrier_off(FAR struct net_driver_s *dev);
 
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy the memory region described by src and len to dst and calculate
+ *   its raw change sum in the same pass.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   dst  - Destination of the copy, which must not overlap src.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dst,
+                     FAR const uint8_t *src, uint16_t len);
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -783,6 +820,32 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset);
 
+/****************************************************************************
+ * Name: chksum_iob_copyin
+ *
+ * Description:
+ *   Copy data into an iob chain like iob_trycopyin() and accumulate its
+ *   raw change sum in the same pass.  The data is summed as part of a
+ *   checksum that starts at an even offset of the chain, so consecutive
+ *   calls may append to the same sum at any offset.
+ *
+ * Input Parameters:
+ *   iob    - The iob chain to copy into, grown as needed.
+ *   src    - The data to copy.
+ *   len    - Length of the data.
+ *   offset - Offset in the iob chain to copy the data to.
+ *   sum    - The checksum to update.
+ *
+ * Returned Value:
+ *   The number of bytes copied on success, a negated errno value if the
+ *   chain could not be grown.
+ *
+ ****************************************************************************/
+
+int chksum_iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, unsigned int offset,
+                      FAR uint16_t *sum);
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -167,6 +167,17 @@ struct netdev_ops_s
   int (*ioctl)(FAR struct netdev_lowerhalf_s *dev, int cmd,
                unsigned long arg);
 #endif
+#ifdef CONFIG_NET_TCP_GSO
+  /* transmit_tso - Optional, send a TCP packet larger than the MTU which
+   *                the hardware splits into segments carrying 'mss' bytes
+   *                of payload each.  The TCP checksum of the packet is not
+   *                filled in.  Ownership rules are the same as transmit.
+   *                If not provided, the upper half segments in software.
+   */
+
+  int (*transmit_tso)(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                      uint16_t mss);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -27,6 +27,15 @@
 
 #include <nuttx/mutex.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initializer for statically allocated read/write semaphores */
+
+#define RWSEM_INITIALIZER {NXMUTEX_INITIALIZER, NXSEM_INITIALIZER(0, 0), \
+                           0, 0, 0}
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -778,6 +778,13 @@ extern "C"
 
 EXTERN clock_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SMP
+/* Maximum and total time spent waiting to enter the critical section. */
+
+EXTERN clock_t g_crit_wait_max[CONFIG_SMP_NCPUS];
+EXTERN clock_t g_crit_wait_total[CONFIG_SMP_NCPUS];
+#endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
 EXTERN const struct tcbinfo_s g_tcbinfo;
@@ -41,11 +41,25 @@ extern "C"
 #define EXTERN extern
 #endif
 
-#if defined(CONFIG_RW_SPINLOCK)
 typedef int rwlock_t;
-#  define RW_SP_UNLOCKED      0
-#  define RW_SP_READ_LOCKED   1
-#  define RW_SP_WRITE_LOCKED -1
+#define RW_SP_UNLOCKED      0
+#define RW_SP_READ_LOCKED   1
+#define RW_SP_WRITE_LOCKED -1
+
+#ifdef CONFIG_MCS_SPINLOCK
+/* A queued (MCS) spinlock is the tail of a queue of waiters.  Each waiter
+ * provides its own node and spins on it, so that releasing the lock only
+ * touches the cache line of the next waiter.
+ */
+
+struct mcs_node_s
+{
+  FAR struct mcs_node_s *next;     /* The next waiter in the queue */
+  bool wait;                       /* True while the lock is held before us */
+};
+
+typedef FAR struct mcs_node_s *mcslock_t;
+#  define MCS_UNLOCKED NULL
 #endif
 
 #ifndef CONFIG_SPINLOCK
@@ -504,8 +518,6 @@ void spin_unlock_irqrestore_wo_note(FAR spinlock_t *lock, irqstate_t flags);
 #  define spin_unlock_irqrestore_wo_note(l, f) up_irq_restore(f)
 #endif
 
-#if defined(CONFIG_RW_SPINLOCK)
-
 /****************************************************************************
  * Name: rwlock_init
  *
@@ -524,6 +536,8 @@ void spin_unlock_irqrestore_wo_note(FAR spinlock_t *lock, irqstate_t flags);
 
 #define rwlock_init(l) do { *(l) = RW_SP_UNLOCKED; } while(0)
 
+#if defined(CONFIG_RW_SPINLOCK)
+
 /****************************************************************************
  * Name: read_lock
  *
@@ -668,6 +682,8 @@ bool write_trylock(FAR volatile rwlock_t *lock);
 
 void write_unlock(FAR volatile rwlock_t *lock);
 
+#endif /* CONFIG_RW_SPINLOCK */
+
 /****************************************************************************
  * Name: read_lock_irqsave
  *
@@ -812,7 +828,158 @@ void write_unlock_irqrestore(FAR rwlock_t *lock, irqstate_t flags);
 #  define write_unlock_irqrestore(l, f) up_irq_restore(f)
 #endif
 
-#endif /* CONFIG_RW_SPINLOCK */
+#ifdef CONFIG_MCS_SPINLOCK
+
+/****************************************************************************
+ * Name: mcs_lock_init
+ *
+ * Description:
+ *   Initialize a queued spinlock object to its initial, unlocked state.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to be initialized.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#define mcs_lock_init(l) do { *(l) = MCS_UNLOCKED; } while (0)
+
+/****************************************************************************
+ * Name: mcs_is_locked
+ *
+ * Description:
+ *   Test if a queued spinlock is held.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to test.
+ *
+ * Returned Value:
+ *   A boolean value: true the spinlock is locked; false if it is unlocked.
+ *
+ ****************************************************************************/
+
+#define mcs_is_locked(l) (*(l) != MCS_UNLOCKED)
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Append this CPU to the queue of waiters and spin on its own node until
+ *   the previous holder hands the lock over.  Waiters get the lock in FIFO
+ *   order.
+ *
+ *   The node is usually a local variable of the caller.  It must remain
+ *   valid and must not be used for anything else until the matching
+ *   mcs_unlock().
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Try once to lock the queued spinlock.  Do not wait if the spinlock is
+ *   already locked.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   false   - Failure, the spinlock was already locked
+ *   true    - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release a queued spinlock, handing it over to the next waiter if there
+ *   is one.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to unlock.
+ *   node - The node passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_lock_irqsave
+ *
+ * Description:
+ *   If SMP is enabled:
+ *     Disable local interrupts and take the queued spinlock.
+ *
+ *   If SMP is not enabled:
+ *     This function is equivalent to up_irq_save().
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to mcs_lock_irqsave(lock, node);
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP)
+irqstate_t mcs_lock_irqsave(FAR volatile mcslock_t *lock,
+                            FAR struct mcs_node_s *node);
+#else
+#  define mcs_lock_irqsave(l, n) ((void)(l), (void)(n), up_irq_save())
+#endif
+
+/****************************************************************************
+ * Name: mcs_unlock_irqrestore
+ *
+ * Description:
+ *   If SMP is enabled:
+ *     Release the queued spinlock and restore the interrupt state as it was
+ *     prior to the previous call to mcs_lock_irqsave(lock, node).
+ *
+ *   If SMP is not enabled:
+ *     This function is equivalent to up_irq_restore().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   node  - The node passed to mcs_lock_irqsave().
+ *   flags - The architecture-specific value that represents the state of
+ *           the interrupts prior to the call to mcs_lock_irqsave();
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP)
+void mcs_unlock_irqrestore(FAR volatile mcslock_t *lock,
+                           FAR struct mcs_node_s *node, irqstate_t flags);
+#else
+#  define mcs_unlock_irqrestore(l, n, f) up_irq_restore(f)
+#endif
+
+#endif /* CONFIG_MCS_SPINLOCK */
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -75,7 +75,15 @@ struct wdog_s
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  FAR struct wdog_s **pprev;     /* Back link used for O(1) removal */
+  clock_t            expired;    /* Absolute expiration time in ticks */
+#else
   sclock_t           lag;        /* Timer associated with the delay */
+#endif
+#ifdef CONFIG_WDOG_PERCPU
+  uint8_t            cpu;        /* CPU queue holding the watchdog */
+#endif
 };
 
 /****************************************************************************
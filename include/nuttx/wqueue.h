@@ -254,6 +254,9 @@ struct work_s
   } u;
   worker_t  worker;         /* Work callback */
   FAR void *arg;            /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t   cpu;            /* The CPU whose queue holds the work */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -361,6 +364,41 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work like work_queue(), but on the queue of the specified CPU
+ *   instead of the queue of the calling CPU.  The work is performed by a
+ *   worker thread of that CPU unless all of them are busy and a worker of
+ *   another CPU is idle.  Without CONFIG_SCHED_WORKQUEUE_PERCPU, and for
+ *   the user-mode work queue, this is the same as work_queue().
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU whose worker threads should perform the work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_WORKQUEUE_PERCPU) && \
+    (!defined(CONFIG_LIBC_USRWORK) || defined(__KERNEL__))
+int work_queue_cpu(int qid, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, int cpu);
+#else
+#  define work_queue_cpu(qid, work, worker, arg, delay, cpu) \
+     work_queue(qid, work, worker, arg, delay)
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -49,6 +49,27 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#ifdef CONFIG_IOB_POOLS
+/* Number of the pools of larger I/O buffers, see CONFIG_IOB_POOLn_* */
+
+#  define IOB_NPOOLS             3
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+/* A pool of larger I/O buffers, protected by g_iob_lock */
+
+struct iob_pool_s
+{
+  FAR struct iob_s *freelist; /* Free I/O buffers of the pool */
+  uint16_t bufsize;           /* Size of the data buffers */
+  uint16_t navail;            /* Number of free I/O buffers */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -83,6 +104,14 @@ extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 
 extern spinlock_t g_iob_lock;
 
+#ifdef CONFIG_IOB_POOLS
+/* The pools of larger I/O buffers, I/O buffers of pool n have io_pool set
+ * to n + 1.
+ */
+
+extern struct iob_pool_s g_iob_pools[IOB_NPOOLS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -122,6 +151,92 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked through io_flink, to the global
+ *   free list, or to the committed list if there are tasks waiting for an
+ *   I/O buffer.  This function is intended only for internal use by the
+ *   IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_CACHE
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU, refilling the cache with
+ *   a batch of I/O buffers from the global free list if it is empty.
+ *   Returns NULL if the allocation must be left to the global free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put an I/O buffer into the cache of this CPU.  Returns false if the I/O
+ *   buffer must be returned to the global free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_initialize
+ *
+ * Description:
+ *   Register the shrinker that flushes the caches when memory runs short.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE
+void iob_cache_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers held by the caches of all CPUs to the global
+ *   free list.  Returns true if any I/O buffer was returned.
+ *
+ ****************************************************************************/
+
+bool iob_cache_flush(void);
+
+/****************************************************************************
+ * Name: iob_cache_disable/iob_cache_enable
+ *
+ * Description:
+ *   iob_cache_disable() flushes the caches and keeps freed I/O buffers out
+ *   of them until the matching iob_cache_enable(), so that a task waiting
+ *   for an I/O buffer sees every I/O buffer freed meanwhile.
+ *
+ ****************************************************************************/
+
+void iob_cache_disable(void);
+void iob_cache_enable(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+
+#endif /* CONFIG_IOB_CACHE */
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -96,6 +96,137 @@ static FAR struct iob_s *iob_alloc_committed(void)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_global
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   global free list without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_global(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0 ||
+      (throttled && g_iob_sem.semcount - CONFIG_IOB_THROTTLE > 0))
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          g_iob_sem.semcount--;
+          DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is a little more complicated because
+           * it can be negative!  Decrementing is still safe, however.
+           *
+           * Note: usually g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE.
+           * But it can be smaller than that if there are blocking threads.
+           */
+
+          g_throttle_sem.semcount--;
+#endif
+
+          spin_unlock_irqrestore(&g_iob_lock, flags);
+          return iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_pool
+ *
+ * Description:
+ *   Try to take an I/O buffer of at least 'len' bytes from the pool with
+ *   the smallest such buffers that is not empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+static FAR struct iob_s *iob_tryalloc_pool(unsigned int len)
+{
+  FAR struct iob_pool_s *best = NULL;
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (i = 0; i < IOB_NPOOLS; i++)
+    {
+      FAR struct iob_pool_s *pool = &g_iob_pools[i];
+
+      if (pool->freelist != NULL && pool->bufsize >= len &&
+          (best == NULL || pool->bufsize < best->bufsize))
+        {
+          best = pool;
+        }
+    }
+
+  if (best != NULL)
+    {
+      iob            = best->freelist;
+      best->freelist = iob->io_flink;
+      best->navail--;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -111,6 +242,9 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   irqstate_t flags;
   FAR sem_t *sem;
   clock_t start;
+#ifdef CONFIG_IOB_CACHE
+  bool nocache = false;
+#endif
   int ret = OK;
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -135,6 +269,20 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
   start = clock_systime_ticks();
   iob   = iob_tryalloc(throttled);
+
+#ifdef CONFIG_IOB_CACHE
+  /* Keep the I/O buffers freed while we wait out of the caches, where we
+   * would not see them.
+   */
+
+  if (iob == NULL)
+    {
+      iob_cache_disable();
+      nocache = true;
+      iob = iob_tryalloc(throttled);
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -193,6 +341,13 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
         }
     }
 
+#ifdef CONFIG_IOB_CACHE
+  if (nocache)
+    {
+      iob_cache_enable();
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -257,75 +412,88 @@ FAR struct iob_s *iob_alloc(bool throttled)
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
   FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
-
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
+#ifdef CONFIG_IOB_CACHE
+  /* Try the cache of this CPU first, then the global free list, and at
+   * last the I/O buffers held by the caches of the other CPUs.
    */
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (sem->semcount > 0 ||
-      (throttled && g_iob_sem.semcount - CONFIG_IOB_THROTTLE > 0))
-#endif
+  iob = iob_cache_alloc(throttled);
+  if (iob == NULL)
     {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
-      if (iob != NULL)
+      iob = iob_tryalloc_global(throttled);
+      if (iob == NULL && iob_cache_flush())
         {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
+          iob = iob_tryalloc_global(throttled);
+        }
+    }
+#else
+  iob = iob_tryalloc_global(throttled);
+#endif
 
-          g_iob_freelist = iob->io_flink;
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
 
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+  return iob;
+}
 
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           *
-           * Note: usually g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE.
-           * But it can be smaller than that if there are blocking threads.
-           */
+/****************************************************************************
+ * Name: iob_alloc_len
+ *
+ * Description:
+ *   Allocate an I/O buffer that should hold 'len' bytes, waiting for a
+ *   buffer of the default pool if the pools of larger buffers are empty.
+ *
+ ****************************************************************************/
 
-          g_throttle_sem.semcount--;
+FAR struct iob_s *iob_alloc_len(bool throttled, unsigned int len)
+{
+#ifdef CONFIG_IOB_POOLS
+  FAR struct iob_s *iob;
+
+  if (len > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_pool(len);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
 #endif
 
-          spin_unlock_irqrestore(&g_iob_lock, flags);
+  return iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_len
+ *
+ * Description:
+ *   Try to allocate an I/O buffer that should hold 'len' bytes without
+ *   waiting for a buffer to become free.
+ *
+ ****************************************************************************/
 
-          /* Put the I/O buffer in a known state */
+FAR struct iob_s *iob_tryalloc_len(bool throttled, unsigned int len)
+{
+#ifdef CONFIG_IOB_POOLS
+  FAR struct iob_s *iob;
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
+  if (len > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_pool(len);
+      if (iob != NULL)
+        {
           return iob;
         }
     }
+#endif
 
-  spin_unlock_irqrestore(&g_iob_lock, flags);
-  return NULL;
+  return iob_tryalloc(throttled);
 }
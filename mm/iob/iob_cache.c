@@ -0,0 +1,427 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/mm.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of I/O buffers moved between a cache and the global free list at
+ * once.
+ */
+
+#define IOB_CACHE_BATCH   (CONFIG_IOB_CACHE_SIZE / 2)
+
+/* Number of I/O buffers that refilling a cache leaves to throttled
+ * allocations from the global free list.
+ */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_CACHE_RESERVE CONFIG_IOB_THROTTLE
+#else
+#  define IOB_CACHE_RESERVE 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct iob_cache_s
+{
+  spinlock_t lock;           /* Taken by the owner CPU or a flush */
+  FAR struct iob_s *head;    /* Cached I/O buffers, linked by io_flink */
+  int count;                 /* Number of cached I/O buffers */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE
+static size_t iob_cache_shrink(FAR void *arg, int level);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* Number of tasks waiting for an I/O buffer with the caches disabled,
+ * protected by g_iob_lock for writes and read under the cache locks.
+ */
+
+static volatile int g_iob_nocache;
+
+#ifdef CONFIG_MM_PRESSURE
+static struct mm_shrinker_s g_iob_shrinker =
+{
+  NULL, iob_cache_shrink, NULL
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_take
+ *
+ * Description:
+ *   Unlink up to 'n' I/O buffers from the head of a cache.
+ *
+ * Assumptions:
+ *   Called with the cache locked.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_take(FAR struct iob_cache_s *cache,
+                                        int n)
+{
+  FAR struct iob_s *head = cache->head;
+  FAR struct iob_s *tail = head;
+  int i;
+
+  if (head == NULL || n <= 0)
+    {
+      return NULL;
+    }
+
+  for (i = 1; i < n && tail->io_flink != NULL; i++)
+    {
+      tail = tail->io_flink;
+    }
+
+  cache->head    = tail->io_flink;
+  cache->count  -= i;
+  tail->io_flink = NULL;
+  return head;
+}
+
+/****************************************************************************
+ * Name: iob_cache_shrink
+ *
+ * Description:
+ *   The shrinker of the I/O buffer caches, see mm_register_shrinker().  The
+ *   I/O buffers live in static pools, so no heap memory comes back and 0 is
+ *   returned; the flush only keeps buffers from sitting idle in the caches
+ *   of other CPUs while the system is short of memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE
+static size_t iob_cache_shrink(FAR void *arg, int level)
+{
+  iob_cache_flush();
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_initialize
+ *
+ * Description:
+ *   Register the shrinker of the I/O buffer caches.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PRESSURE
+void iob_cache_initialize(void)
+{
+  mm_register_shrinker(&g_iob_shrinker);
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU, refilling the cache with
+ *   a batch of I/O buffers from the global free list if it is empty.
+ *   Returns NULL if the allocation must be left to the global free list.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *list = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int navail;
+  int n = 0;
+
+  /* The lock is only contended by a flush, so it does not matter if we
+   * move to another CPU before it is taken.
+   */
+
+  cache = &g_iob_cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      /* A throttled allocation may only take a cached I/O buffer if the
+       * global free list still holds the throttle reserve.
+       */
+
+      if (throttled && g_iob_sem.semcount < IOB_CACHE_RESERVE)
+        {
+          iob = NULL;
+        }
+      else
+        {
+          cache->head = iob->io_flink;
+          cache->count--;
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return iob;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  /* The cache is empty, refill it with the I/O buffers above the throttle
+   * reserve, one for the caller and a batch for the cache.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  if (g_iob_nocache == 0)
+    {
+      navail = g_iob_sem.semcount - IOB_CACHE_RESERVE;
+      while (n < IOB_CACHE_BATCH + 1 && n < navail &&
+             g_iob_freelist != NULL)
+        {
+          iob            = g_iob_freelist;
+          g_iob_freelist = iob->io_flink;
+          iob->io_flink  = list;
+          list           = iob;
+          if (tail == NULL)
+            {
+              tail = iob;
+            }
+
+          n++;
+        }
+
+      /* Take the semaphore counts, see iob_tryalloc_global() */
+
+      g_iob_sem.semcount -= n;
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
+#if CONFIG_IOB_THROTTLE > 0
+      g_throttle_sem.semcount -= n;
+#endif
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (list == NULL)
+    {
+      return NULL;
+    }
+
+  iob  = list;
+  list = list->io_flink;
+  if (list != NULL)
+    {
+      cache = &g_iob_cache[up_cpu_index()];
+      flags = spin_lock_irqsave(&cache->lock);
+
+      if (g_iob_nocache == 0)
+        {
+          tail->io_flink = cache->head;
+          cache->head    = list;
+          cache->count  += n - 1;
+          list           = NULL;
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      /* A task started waiting meanwhile, it needs these I/O buffers */
+
+      if (list != NULL)
+        {
+          iob_free_global(list);
+        }
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put an I/O buffer into the cache of this CPU.  Returns false if the I/O
+ *   buffer must be returned to the global free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *list = NULL;
+  irqstate_t flags;
+
+  cache = &g_iob_cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  /* A task waiting for an I/O buffer must see this one.  Checking under
+   * the cache lock pairs with the flush in iob_cache_disable().
+   */
+
+  if (g_iob_nocache > 0)
+    {
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return false;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  if (++cache->count > CONFIG_IOB_CACHE_SIZE)
+    {
+      list = iob_cache_take(cache, IOB_CACHE_BATCH);
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (list != NULL)
+    {
+      iob_free_global(list);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers held by the caches of all CPUs to the global
+ *   free list.  Returns true if any I/O buffer was returned.
+ *
+ ****************************************************************************/
+
+bool iob_cache_flush(void)
+{
+  bool ret = false;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct iob_cache_s *cache = &g_iob_cache[i];
+      FAR struct iob_s *list;
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&cache->lock);
+      list  = iob_cache_take(cache, cache->count);
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (list != NULL)
+        {
+          iob_free_global(list);
+          ret = true;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_cache_disable
+ *
+ * Description:
+ *   Flush the caches and keep freed I/O buffers out of them until the
+ *   matching iob_cache_enable(), so that a task waiting for an I/O buffer
+ *   sees every I/O buffer freed meanwhile.
+ *
+ ****************************************************************************/
+
+void iob_cache_disable(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  g_iob_nocache++;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  iob_cache_flush();
+}
+
+/****************************************************************************
+ * Name: iob_cache_enable
+ *
+ * Description:
+ *   Undo one iob_cache_disable().
+ *
+ ****************************************************************************/
+
+void iob_cache_enable(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  DEBUGASSERT(g_iob_nocache > 0);
+  g_iob_nocache--;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the caches of all CPUs.  The
+ *   result is a snapshot that may be stale by the time it is used.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      navail += g_iob_cache[i].count;
+    }
+
+  return navail;
+}
@@ -62,6 +62,73 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked through io_flink, to the global
+ *   free list, or to the committed list if there are tasks waiting for an
+ *   I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int nfree = 0;
+
+  /* Free the I/O buffers by adding them to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (; iob != NULL; iob = next, nfree++)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()).
+       */
+
+      if (g_iob_sem.semcount + nfree < 0)
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+        }
+      else
+        {
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Signal that an IOB is available.  If there is a thread blocked,
+   * waiting for an IOB, this will wake up exactly one thread.  The
+   * semaphore count will correctly indicated that the awakened task
+   * owns an IOB and should find it in the committed list.
+   */
+
+  while (nfree-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+      nxsem_post(&g_throttle_sem);
+      DEBUGASSERT(g_throttle_sem.semcount <=
+                  (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -74,7 +141,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
 #endif
@@ -112,47 +178,36 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
+#ifdef CONFIG_IOB_POOLS
+  /* I/O buffers of the pools of larger buffers go back to their pool.
+   * Nobody waits for them, so there is nothing to signal.
    */
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()).
-   */
-
-  if (g_iob_sem.semcount < 0)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-    }
-  else
+  if (iob->io_pool != 0)
     {
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
+      FAR struct iob_pool_s *pool = &g_iob_pools[iob->io_pool - 1];
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob->io_flink  = pool->freelist;
+      pool->freelist = iob;
+      pool->navail++;
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      return next;
     }
+#endif
 
-  spin_unlock_irqrestore(&g_iob_lock, flags);
-
-  /* Signal that an IOB is available.  If there is a thread blocked,
-   * waiting for an IOB, this will wake up exactly one thread.  The
-   * semaphore count will correctly indicated that the awakened task
-   * owns an IOB and should find it in the committed list.
+  /* Keep the I/O buffer in the cache of this CPU if possible, or return
+   * it to the global free list.
    */
 
-  nxsem_post(&g_iob_sem);
-  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
-
-#if CONFIG_IOB_THROTTLE > 0
-  nxsem_post(&g_throttle_sem);
-  DEBUGASSERT(g_throttle_sem.semcount <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#ifdef CONFIG_IOB_CACHE
+  if (!iob_cache_free(iob))
 #endif
+    {
+      iob->io_flink = NULL;
+      iob_free_global(iob);
+    }
 
 #ifdef CONFIG_IOB_NOTIFIER
   /* Check if the IOB was claimed by a thread that is blocked waiting
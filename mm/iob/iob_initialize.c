@@ -36,11 +36,28 @@
 
 #define ROUNDUP(x, y)     (((x) + (y) - 1) / (y) * (y))
 
+#ifdef CONFIG_IOB_POOLS
+/* Each I/O buffer is followed by its data buffer, both aligned to
+ * CONFIG_IOB_ALIGNMENT and to the alignment of the I/O buffer itself.
+ */
+
+#  define IOB_POOL_ALIGN  (CONFIG_IOB_ALIGNMENT > sizeof(uintptr_t) ? \
+                           CONFIG_IOB_ALIGNMENT : sizeof(uintptr_t))
+#  define IOB_HDR_SIZE    ROUNDUP(sizeof(struct iob_s), IOB_POOL_ALIGN)
+#  define IOB_POOL_STRIDE(bufsize) \
+                          (IOB_HDR_SIZE + ROUNDUP(bufsize, IOB_POOL_ALIGN))
+#  define IOB_POOL_SIZE(bufsize, n) \
+                          (IOB_POOL_STRIDE(bufsize) * (n) + IOB_POOL_ALIGN - 1)
+
+#  define IOB_BUFFER_SIZE IOB_POOL_SIZE(CONFIG_IOB_BUFSIZE, \
+                                        CONFIG_IOB_NBUFFERS)
+#else
 /* Fix the I/O Buffer size with specified alignment size */
 
-#define IOB_ALIGN_SIZE    ROUNDUP(sizeof(struct iob_s), CONFIG_IOB_ALIGNMENT)
-#define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
+#  define IOB_ALIGN_SIZE  ROUNDUP(sizeof(struct iob_s), CONFIG_IOB_ALIGNMENT)
+#  define IOB_BUFFER_SIZE (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
                            CONFIG_IOB_ALIGNMENT - 1)
+#endif
 
 /****************************************************************************
  * Private Data
@@ -57,6 +74,29 @@ static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
+#ifdef CONFIG_IOB_POOLS
+/* Raw buffers of the pools of larger I/O buffers */
+
+#  ifdef IOB_SECTION
+static uint8_t g_iob_pool1_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL1_BUFSIZE,
+                                                CONFIG_IOB_POOL1_NBUFFERS)]
+  locate_data(IOB_SECTION);
+static uint8_t g_iob_pool2_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL2_BUFSIZE,
+                                                CONFIG_IOB_POOL2_NBUFFERS)]
+  locate_data(IOB_SECTION);
+static uint8_t g_iob_pool3_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL3_BUFSIZE,
+                                                CONFIG_IOB_POOL3_NBUFFERS)]
+  locate_data(IOB_SECTION);
+#  else
+static uint8_t g_iob_pool1_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL1_BUFSIZE,
+                                                CONFIG_IOB_POOL1_NBUFFERS)];
+static uint8_t g_iob_pool2_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL2_BUFSIZE,
+                                                CONFIG_IOB_POOL2_NBUFFERS)];
+static uint8_t g_iob_pool3_buffer[IOB_POOL_SIZE(CONFIG_IOB_POOL3_BUFSIZE,
+                                                CONFIG_IOB_POOL3_NBUFFERS)];
+#  endif
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* This is a pool of pre-allocated iob_qentry_s buffers */
 
@@ -104,6 +144,50 @@ sem_t g_qentry_sem = SEM_INITIALIZER(CONFIG_IOB_NCHAINS);
 
 spinlock_t g_iob_lock = SP_UNLOCKED;
 
+#ifdef CONFIG_IOB_POOLS
+/* The pools of larger I/O buffers */
+
+struct iob_pool_s g_iob_pools[IOB_NPOOLS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+/****************************************************************************
+ * Name: iob_initpool
+ *
+ * Description:
+ *   Divide a raw buffer into 'nbuffers' I/O buffers with 'bufsize' bytes
+ *   of data each, and add them to a free list.
+ *
+ ****************************************************************************/
+
+static void iob_initpool(FAR uint8_t *buffer, int nbuffers,
+                         uint16_t bufsize, uint8_t pool,
+                         FAR struct iob_s **freelist)
+{
+  uintptr_t buf = ROUNDUP((uintptr_t)buffer, IOB_POOL_ALIGN);
+  int i;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob =
+        (FAR struct iob_s *)(buf + i * IOB_POOL_STRIDE(bufsize));
+
+      iob->io_bufsize = bufsize;
+      iob->io_pool    = pool;
+      iob->io_data    = (FAR uint8_t *)iob + IOB_HDR_SIZE;
+
+      /* Add the pre-allocate I/O buffer to the head of the free list */
+
+      iob->io_flink   = *freelist;
+      *freelist       = iob;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,6 +203,27 @@ spinlock_t g_iob_lock = SP_UNLOCKED;
 void iob_initialize(void)
 {
   int i;
+#ifdef CONFIG_IOB_POOLS
+  /* Set up the default pool and the pools of larger I/O buffers */
+
+  iob_initpool(g_iob_buffer, CONFIG_IOB_NBUFFERS, CONFIG_IOB_BUFSIZE, 0,
+               &g_iob_freelist);
+
+  g_iob_pools[0].bufsize = CONFIG_IOB_POOL1_BUFSIZE;
+  g_iob_pools[0].navail  = CONFIG_IOB_POOL1_NBUFFERS;
+  iob_initpool(g_iob_pool1_buffer, CONFIG_IOB_POOL1_NBUFFERS,
+               CONFIG_IOB_POOL1_BUFSIZE, 1, &g_iob_pools[0].freelist);
+
+  g_iob_pools[1].bufsize = CONFIG_IOB_POOL2_BUFSIZE;
+  g_iob_pools[1].navail  = CONFIG_IOB_POOL2_NBUFFERS;
+  iob_initpool(g_iob_pool2_buffer, CONFIG_IOB_POOL2_NBUFFERS,
+               CONFIG_IOB_POOL2_BUFSIZE, 2, &g_iob_pools[1].freelist);
+
+  g_iob_pools[2].bufsize = CONFIG_IOB_POOL3_BUFSIZE;
+  g_iob_pools[2].navail  = CONFIG_IOB_POOL3_NBUFFERS;
+  iob_initpool(g_iob_pool3_buffer, CONFIG_IOB_POOL3_NBUFFERS,
+               CONFIG_IOB_POOL3_BUFSIZE, 3, &g_iob_pools[2].freelist);
+#else
   uintptr_t buf;
 
   /* Get a start address which plus offsetof(struct iob_s, io_data) is
@@ -141,6 +246,7 @@ void iob_initialize(void)
       iob->io_flink  = g_iob_freelist;
       g_iob_freelist = iob;
     }
+#endif
 
 #if CONFIG_IOB_NCHAINS > 0
   /* Add each I/O buffer chain queue container to the free list */
@@ -157,4 +263,8 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#if defined(CONFIG_IOB_CACHE) && defined(CONFIG_MM_PRESSURE)
+  iob_cache_initialize();
+#endif
 }
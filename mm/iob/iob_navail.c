@@ -55,6 +55,12 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#ifdef CONFIG_IOB_CACHE
+      /* The I/O buffers held by the caches are available as well */
+
+      ret += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
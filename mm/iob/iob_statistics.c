@@ -65,6 +65,12 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+#ifdef CONFIG_IOB_CACHE
+  /* The I/O buffers held by the caches are free as well */
+
+  stats->nfree += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   nxsem_get_value(&g_throttle_sem, &stats->nthrottle);
   if (stats->nthrottle < 0)
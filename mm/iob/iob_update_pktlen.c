@@ -49,77 +49,52 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 {
   FAR struct iob_s *penultimate;
   FAR struct iob_s *next;
-  uint16_t offset = 0;
-  int ninqueue = 0;
-  int nrequire;
-  uint16_t len;
-
-  /* The data offset must be less than CONFIG_IOB_BUFSIZE */
+  unsigned int remain;
+  unsigned int len;
 
   if (iob == NULL)
     {
       return -EINVAL;
     }
 
-  /* Calculate the total entries of the data in the I/O buffer chain */
+  /* Find the entries that are needed to hold the data, the size of the
+   * I/O buffers may differ.
+   */
 
-  next = iob;
-  while (next != NULL)
+  next   = iob;
+  remain = pktlen;
+  do
     {
-      ninqueue++;
-      offset += next->io_offset;
+      len         = IOB_BUFSIZE(next) - next->io_offset;
+      remain     -= remain > len ? len : remain;
       penultimate = next;
-      next = next->io_flink;
+      next        = next->io_flink;
     }
+  while (next != NULL && remain > 0);
 
-  /* Trim inqueue entries if needed */
-
-  nrequire = (pktlen + offset + CONFIG_IOB_BUFSIZE - 1) /
-             CONFIG_IOB_BUFSIZE;
-  if (nrequire == 0)
+  if (next != NULL)
     {
-      nrequire = 1;
-    }
+      /* Trim the entries that are no longer needed */
 
-  if (nrequire < ninqueue)
+      penultimate->io_flink = NULL;
+      iob_free_chain(next);
+    }
+  else
     {
-      /* Loop until complete the trim */
-
-      next = iob;
-      penultimate = NULL;
+      /* Extend the chain from the last IOB */
 
-      while (next != NULL)
+      while (remain > 0)
         {
-          if (nrequire-- <= 0)
+          next = iob_tryalloc(throttled);
+          if (next == NULL)
             {
-              if (penultimate != NULL)
-                {
-                  penultimate->io_flink = NULL;
-                }
-
-              iob_free_chain(next);
               break;
             }
-          else
-            {
-              penultimate = next;
-              next = next->io_flink;
-            }
-        }
-    }
-  else if (nrequire > ninqueue)
-    {
-      /* Start from the last IOB */
 
-      next = penultimate;
-
-      /* Loop to extend the link */
-
-      while (next != NULL && nrequire > ninqueue)
-        {
-          next->io_flink = iob_tryalloc(throttled);
-          next = next->io_flink;
-          ninqueue++;
+          penultimate->io_flink = next;
+          penultimate           = next;
+          remain               -= remain > IOB_BUFSIZE(next) ?
+                                  IOB_BUFSIZE(next) : remain;
         }
     }
 
@@ -130,9 +105,9 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
   next = iob;
   while (next != NULL && pktlen > 0)
     {
-      if (pktlen + next->io_offset > CONFIG_IOB_BUFSIZE)
+      if (pktlen + next->io_offset > IOB_BUFSIZE(next))
         {
-          len = CONFIG_IOB_BUFSIZE - next->io_offset;
+          len = IOB_BUFSIZE(next) - next->io_offset;
         }
       else
         {
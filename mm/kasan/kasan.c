@@ -28,6 +28,7 @@
 #include <debug.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "kasan.h"
 
@@ -43,10 +44,47 @@
 #define KASAN_LAST_WORD_MASK(end) \
   (UINTPTR_MAX >> (-(end) & (KASAN_BITS_PER_WORD - 1)))
 
-#define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
+#define KASAN_ALIGN_UP(a, align) \
+  (((a) + (align) - 1) & ~((align) - 1))
+#define KASAN_ALIGN_DOWN(a, align) \
+  ((a) & ~((align) - 1))
+
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+/* One tag byte in the shadow describes a granule of 16 bytes */
+
+#  define KASAN_SHADOW_SCALE  16
+
+#  define KASAN_SHADOW_SIZE(size) \
+  KASAN_ALIGN_UP((size) / KASAN_SHADOW_SCALE, KASAN_BYTES_PER_WORD)
+
+/* The tag lives in the top byte of a pointer, which the MMU ignores.
+ * Untagged pointers (to globals, stacks or memory that was never tagged)
+ * match every tag, freed memory is tagged with KASAN_TAG_INVALID, which
+ * no pointer carries.
+ */
+
+#  define KASAN_TAG_SHIFT     56
+#  define KASAN_TAG_KERNEL    0x00
+#  define KASAN_TAG_INVALID   0xfe
+#  define KASAN_TAG_MAX       0xfd
+
+#  define KASAN_GET_TAG(addr) \
+  ((uint8_t)((uintptr_t)(addr) >> KASAN_TAG_SHIFT))
+#  define KASAN_RESET_TAG(addr) \
+  ((uintptr_t)(addr) & ~((uintptr_t)0xff << KASAN_TAG_SHIFT))
+#else
+/* One bit in the shadow describes a granule of one word */
+
+#  define KASAN_SHADOW_SCALE  (sizeof(uintptr_t))
+
+#  define KASAN_SHADOW_SIZE(size) \
+  (KASAN_BYTES_PER_WORD * \
+   KASAN_ALIGN_UP((size) / KASAN_SHADOW_SCALE, KASAN_BITS_PER_WORD) / \
+   KASAN_BITS_PER_WORD)
+
+#  define KASAN_RESET_TAG(addr) ((uintptr_t)(addr))
+#endif
 
-#define KASAN_SHADOW_SIZE(size) \
-  (KASAN_BYTES_PER_WORD * ((size) / KASAN_SHADOW_SCALE / KASAN_BITS_PER_WORD))
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
@@ -61,7 +99,12 @@ struct kasan_region_s
   FAR struct kasan_region_s *next;
   uintptr_t                  begin;
   uintptr_t                  end;
+  bool                       enabled;  /* Accesses are checked */
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+  uint8_t                    shadow[1] aligned_data(sizeof(uintptr_t));
+#else
   uintptr_t                  shadow[1];
+#endif
 };
 
 /****************************************************************************
@@ -72,15 +115,17 @@ static spinlock_t g_lock;
 static FAR struct kasan_region_s *g_region;
 static uint32_t g_region_init;
 
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+static uint32_t g_tag_seed = 1;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                                          unsigned int *bit)
+static FAR struct kasan_region_s *kasan_find_region(uintptr_t addr)
 {
   FAR struct kasan_region_s *region;
-  uintptr_t addr = (uintptr_t)ptr;
 
   if (g_region_init != KASAN_INIT_VALUE)
     {
@@ -91,11 +136,7 @@ static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
     {
       if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= region->end);
-          addr -= region->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &region->shadow[addr / KASAN_BITS_PER_WORD];
+          return region;
         }
     }
 
@@ -110,38 +151,211 @@ static void kasan_report(FAR const void *addr, size_t size,
 
   if (++recursion == 1)
     {
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+      FAR struct kasan_region_s *region;
+      uintptr_t uaddr = KASAN_RESET_TAG(addr);
+      int memtag = -1;
+
+      region = kasan_find_region(uaddr);
+      if (region != NULL)
+        {
+          memtag = region->shadow[(uaddr - region->begin) /
+                                  KASAN_SHADOW_SCALE];
+        }
+
+      _alert("kasan detected a %s access error, address at %p, "
+             "size is %zu, pointer tag 0x%02x, memory tag 0x%02x, "
+             "return address: %p\n",
+             is_write ? "write" : "read", addr, size,
+             KASAN_GET_TAG(addr), memtag, return_address);
+#else
       _alert("kasan detected a %s access error, address at %p,"
              "size is %zu, return address: %p\n",
              is_write ? "write" : "read",
              addr, size, return_address);
+#endif
       PANIC();
     }
 
   --recursion;
 }
 
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+
+/* Generate a random tag that can be given to a pointer */
+
+static uint8_t kasan_random_tag(void)
+{
+  /* Races on the seed are harmless, they just mix it a little more */
+
+  g_tag_seed = g_tag_seed * 1103515245 + 12345;
+  return (g_tag_seed >> 16) % KASAN_TAG_MAX + 1;
+}
+
+/* The access is bad if a granule it touches has another tag than the
+ * pointer.  The shadow bytes are compared a word at a time.
+ */
+
 static bool kasan_is_poisoned(FAR const void *addr, size_t size)
 {
+  FAR struct kasan_region_s *region;
+  FAR const uint8_t *p;
+  uintptr_t uaddr;
+  uintptr_t pattern;
+  size_t first;
+  size_t n;
+  uint8_t tag;
+
+  tag = KASAN_GET_TAG(addr);
+  if (tag == KASAN_TAG_KERNEL || size == 0)
+    {
+      return false;
+    }
+
+  uaddr  = KASAN_RESET_TAG(addr);
+  region = kasan_find_region(uaddr);
+  if (region == NULL || !region->enabled)
+    {
+      return false;
+    }
+
+  if (size > region->end - uaddr)
+    {
+      return true;
+    }
+
+  first = (uaddr - region->begin) / KASAN_SHADOW_SCALE;
+  n     = (uaddr + size - 1 - region->begin) / KASAN_SHADOW_SCALE -
+          first + 1;
+  p     = &region->shadow[first];
+
+  while (n > 0 && ((uintptr_t)p & (KASAN_BYTES_PER_WORD - 1)) != 0)
+    {
+      if (*p++ != tag)
+        {
+          return true;
+        }
+
+      n--;
+    }
+
+  pattern = (UINTPTR_MAX / 0xff) * tag;
+  for (; n >= KASAN_BYTES_PER_WORD; n -= KASAN_BYTES_PER_WORD)
+    {
+      if (*(FAR const uintptr_t *)p != pattern)
+        {
+          return true;
+        }
+
+      p += KASAN_BYTES_PER_WORD;
+    }
+
+  while (n-- > 0)
+    {
+      if (*p++ != tag)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/* Tag all granules of a range, partial granules at both ends included */
+
+static void kasan_set_memory_tag(FAR const void *addr, size_t size,
+                                 uint8_t tag)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t uaddr = KASAN_RESET_TAG(addr);
+  size_t first;
+  size_t last;
+
+  region = kasan_find_region(uaddr);
+  DEBUGASSERT(region != NULL && size <= region->end - uaddr);
+
+  if (region != NULL && size > 0)
+    {
+      first = (uaddr - region->begin) / KASAN_SHADOW_SCALE;
+      last  = (uaddr + size - 1 - region->begin) / KASAN_SHADOW_SCALE;
+      memset(&region->shadow[first], tag, last - first + 1);
+    }
+}
+
+#else /* CONFIG_MM_KASAN_SW_TAGS */
+
+/* The access is bad if a granule it touches is poisoned.  The shadow bits
+ * are tested a word at a time.
+ */
+
+static bool kasan_is_poisoned(FAR const void *addr, size_t size)
+{
+  FAR struct kasan_region_s *region;
   FAR uintptr_t *p;
-  unsigned int bit;
+  FAR uintptr_t *last;
+  uintptr_t mask;
+  size_t first;
+  size_t end;
+
+  region = kasan_find_region((uintptr_t)addr);
+  if (region == NULL || !region->enabled || size == 0)
+    {
+      return false;
+    }
+
+  if (size > region->end - (uintptr_t)addr)
+    {
+      return true;
+    }
+
+  first = ((uintptr_t)addr - region->begin) / KASAN_SHADOW_SCALE;
+  end   = ((uintptr_t)addr + size - 1 - region->begin) /
+          KASAN_SHADOW_SCALE + 1;
 
-  p = kasan_mem_to_shadow(addr + size - 1, 1, &bit);
-  return p && ((*p >> bit) & 1);
+  p     = &region->shadow[first / KASAN_BITS_PER_WORD];
+  last  = &region->shadow[(end - 1) / KASAN_BITS_PER_WORD];
+  mask  = KASAN_FIRST_WORD_MASK(first);
+
+  if (p == last)
+    {
+      return (*p & mask & KASAN_LAST_WORD_MASK(end)) != 0;
+    }
+
+  if ((*p & mask) != 0)
+    {
+      return true;
+    }
+
+  while (++p < last)
+    {
+      if (*p != 0)
+        {
+          return true;
+        }
+    }
+
+  return (*p & KASAN_LAST_WORD_MASK(end)) != 0;
 }
 
 static void kasan_set_poison(FAR const void *addr, size_t size,
                              bool poisoned)
 {
+  FAR struct kasan_region_s *region;
   FAR uintptr_t *p;
   unsigned int bit;
   unsigned int nbit;
   uintptr_t mask;
+  uintptr_t offset;
   int flags;
 
   flags = spin_lock_irqsave(&g_lock);
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  DEBUGASSERT(p != NULL);
+  region = kasan_find_region((uintptr_t)addr);
+  DEBUGASSERT(region != NULL && size <= region->end - (uintptr_t)addr);
+
+  offset = ((uintptr_t)addr - region->begin) / KASAN_SHADOW_SCALE;
+  p      = &region->shadow[offset / KASAN_BITS_PER_WORD];
+  bit    = offset % KASAN_BITS_PER_WORD;
 
   nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
   mask = KASAN_FIRST_WORD_MASK(bit);
@@ -181,13 +395,15 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
   spin_unlock_irqrestore(&g_lock, flags);
 }
 
+#endif /* CONFIG_MM_KASAN_SW_TAGS */
+
 static inline void kasan_check_report(FAR const void *addr, size_t size,
                                       bool is_write,
                                       FAR void *return_address)
 {
   if (kasan_is_poisoned(addr, size))
     {
-      kasan_report(addr, size, false, return_address);
+      kasan_report(addr, size, is_write, return_address);
     }
 }
 
@@ -197,6 +413,28 @@ static inline void kasan_check_report(FAR const void *addr, size_t size,
 
 /* Exported functions called from other mm module */
 
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+void kasan_poison(FAR const void *addr, size_t size)
+{
+  kasan_set_memory_tag(addr, size, KASAN_TAG_INVALID);
+}
+
+void kasan_unpoison(FAR const void *addr, size_t size)
+{
+  kasan_set_memory_tag(addr, size, KASAN_GET_TAG(addr));
+}
+
+FAR void *kasan_set_tag(FAR const void *addr)
+{
+  return (FAR void *)(KASAN_RESET_TAG(addr) |
+                      ((uintptr_t)kasan_random_tag() << KASAN_TAG_SHIFT));
+}
+
+FAR void *kasan_reset_tag(FAR const void *addr)
+{
+  return (FAR void *)KASAN_RESET_TAG(addr);
+}
+#else
 void kasan_poison(FAR const void *addr, size_t size)
 {
   kasan_set_poison(addr, size, true);
@@ -206,6 +444,7 @@ void kasan_unpoison(FAR const void *addr, size_t size)
 {
   kasan_set_poison(addr, size, false);
 }
+#endif
 
 void kasan_register(FAR void *addr, FAR size_t *size)
 {
@@ -213,10 +452,16 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   int flags;
 
   region = (FAR struct kasan_region_s *)
-    ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
+    KASAN_ALIGN_DOWN((uintptr_t)addr + *size - KASAN_REGION_SIZE(*size),
+                     sizeof(uintptr_t));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+#ifdef CONFIG_MM_KASAN_HEAP_DEFAULT
+  region->enabled = true;
+#else
+  region->enabled = false;
+#endif
 
   flags = spin_lock_irqsave(&g_lock);
   region->next  = g_region;
@@ -224,10 +469,68 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   g_region_init = KASAN_INIT_VALUE;
   spin_unlock_irqrestore(&g_lock, flags);
 
-  kasan_poison(addr, *size);
-  *size -= KASAN_REGION_SIZE(*size);
+  kasan_poison(addr, (uintptr_t)region - (uintptr_t)addr);
+  *size = (uintptr_t)region - (uintptr_t)addr;
+}
+
+void kasan_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+
+  region = kasan_find_region(KASAN_RESET_TAG(addr));
+  if (region != NULL)
+    {
+      region->enabled = enable;
+    }
+}
+
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+/* Exported functions called from the code generated by
+ * -fsanitize=kernel-hwaddress
+ */
+
+void __hwasan_loadN_noabort(uintptr_t addr, uintptr_t size)
+{
+  kasan_check_report((FAR const void *)addr, size, false,
+                     return_address(0));
+}
+
+void __hwasan_storeN_noabort(uintptr_t addr, uintptr_t size)
+{
+  kasan_check_report((FAR const void *)addr, size, true,
+                     return_address(0));
+}
+
+void __hwasan_tag_memory(uintptr_t addr, uint8_t tag, uintptr_t size)
+{
+  kasan_set_memory_tag((FAR const void *)addr, size, tag);
+}
+
+uint8_t __hwasan_generate_tag(void)
+{
+  return kasan_random_tag();
 }
 
+#define DEFINE_HWASAN_LOAD_STORE(size) \
+  void __hwasan_load##size##_noabort(uintptr_t addr) \
+  { \
+    kasan_check_report((FAR const void *)addr, size, false, \
+                       return_address(0)); \
+  } \
+  void __hwasan_store##size##_noabort(uintptr_t addr) \
+  { \
+    kasan_check_report((FAR const void *)addr, size, true, \
+                       return_address(0)); \
+  }
+
+DEFINE_HWASAN_LOAD_STORE(1)
+DEFINE_HWASAN_LOAD_STORE(2)
+DEFINE_HWASAN_LOAD_STORE(4)
+DEFINE_HWASAN_LOAD_STORE(8)
+DEFINE_HWASAN_LOAD_STORE(16)
+
+#else /* CONFIG_MM_KASAN_SW_TAGS */
+
 /* Exported functions called from the compiler generated code */
 
 void __sanitizer_annotate_contiguous_container(FAR const void *beg,
@@ -314,3 +617,5 @@ DEFINE_ASAN_LOAD_STORE(2)
 DEFINE_ASAN_LOAD_STORE(4)
 DEFINE_ASAN_LOAD_STORE(8)
 DEFINE_ASAN_LOAD_STORE(16)
+
+#endif /* CONFIG_MM_KASAN_SW_TAGS */
@@ -25,6 +25,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /****************************************************************************
@@ -35,6 +36,12 @@
 #  define kasan_poison(addr, size)
 #  define kasan_unpoison(addr, size)
 #  define kasan_register(addr, size)
+#  define kasan_enable(addr, enable)
+#endif
+
+#ifndef CONFIG_MM_KASAN_SW_TAGS
+#  define kasan_set_tag(addr)   ((FAR void *)(addr))
+#  define kasan_reset_tag(addr) ((FAR void *)(addr))
 #endif
 
 /****************************************************************************
@@ -72,7 +79,8 @@ void kasan_poison(FAR const void *addr, size_t size);
  * Name: kasan_unpoison
  *
  * Description:
- *   Mark the memory range as accessible
+ *   Mark the memory range as accessible.  In the tag-based mode, the range
+ *   is accessible through pointers with the tag of addr.
  *
  * Input Parameters:
  *   addr - range start address
@@ -105,6 +113,62 @@ void kasan_unpoison(FAR const void *addr, size_t size);
 
 void kasan_register(FAR void *addr, FAR size_t *size);
 
+/****************************************************************************
+ * Name: kasan_enable
+ *
+ * Description:
+ *   Enable or disable the access check of a registered memory range.  The
+ *   shadow is kept up to date either way, so the check can be enabled at
+ *   any time.
+ *
+ * Input Parameters:
+ *   addr   - an address in the range
+ *   enable - true to check the accesses to the range
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void kasan_enable(FAR const void *addr, bool enable);
+
+#ifdef CONFIG_MM_KASAN_SW_TAGS
+
+/****************************************************************************
+ * Name: kasan_set_tag
+ *
+ * Description:
+ *   Return the address with a new random tag.  The memory must be
+ *   unpoisoned through the returned pointer to take the same tag.
+ *
+ * Input Parameters:
+ *   addr - the address to tag
+ *
+ * Returned Value:
+ *   The tagged address.
+ *
+ ****************************************************************************/
+
+FAR void *kasan_set_tag(FAR const void *addr);
+
+/****************************************************************************
+ * Name: kasan_reset_tag
+ *
+ * Description:
+ *   Return the address without its tag, which accesses the memory
+ *   unchecked.
+ *
+ * Input Parameters:
+ *   addr - the tagged address
+ *
+ * Returned Value:
+ *   The untagged address.
+ *
+ ****************************************************************************/
+
+FAR void *kasan_reset_tag(FAR const void *addr);
+
+#endif /* CONFIG_MM_KASAN_SW_TAGS */
 #endif /* CONFIG_MM_KASAN */
 
 #undef EXTERN
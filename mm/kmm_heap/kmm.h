@@ -0,0 +1,101 @@
+/****************************************************************************
+ * mm/kmm_heap/kmm.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_KMM_HEAP_KMM_H
+#define __MM_KMM_HEAP_KMM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef CONFIG_MM_HEAP_LARGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Allocations of this size or larger are mapped from the page allocator */
+
+#define KMM_LARGE(size) ((size) >= CONFIG_MM_HEAP_LARGE_THRESHOLD)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_large_memalign
+ *
+ * Description:
+ *   Map a large allocation from pages of the page allocator.  Returns NULL
+ *   if the allocation must be left to the kernel heap.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_large_memalign(size_t alignment, size_t size);
+
+/****************************************************************************
+ * Name: kmm_large_free
+ *
+ * Description:
+ *   Unmap a large allocation and return its pages to the page allocator.
+ *
+ ****************************************************************************/
+
+void kmm_large_free(FAR void *mem);
+
+/****************************************************************************
+ * Name: kmm_large_member
+ *
+ * Description:
+ *   Return true if 'mem' was returned by kmm_large_memalign().
+ *
+ ****************************************************************************/
+
+bool kmm_large_member(FAR void *mem);
+
+/****************************************************************************
+ * Name: kmm_large_size
+ *
+ * Description:
+ *   Return the usable size of a large allocation.
+ *
+ ****************************************************************************/
+
+size_t kmm_large_size(FAR void *mem);
+
+/****************************************************************************
+ * Name: kmm_large_mallinfo
+ *
+ * Description:
+ *   Add the memory mapped for large allocations to the kernel heap
+ *   statistics.
+ *
+ ****************************************************************************/
+
+void kmm_large_mallinfo(FAR struct mallinfo *info);
+
+#endif /* CONFIG_MM_HEAP_LARGE */
+#endif /* __MM_KMM_HEAP_KMM_H */
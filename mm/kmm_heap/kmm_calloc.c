@@ -24,8 +24,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -42,6 +46,13 @@
 
 FAR void *kmm_calloc(size_t n, size_t elem_size)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (n > 0 && elem_size <= SIZE_MAX / n && KMM_LARGE(n * elem_size))
+    {
+      return kmm_zalloc(n * elem_size);
+    }
+#endif
+
   return mm_calloc(g_kmmheap, n, elem_size);
 }
 
@@ -29,6 +29,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -52,6 +54,14 @@
 
 void kmm_free(FAR void *mem)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (mem != NULL && kmm_large_member(mem))
+    {
+      kmm_large_free(mem);
+      return;
+    }
+#endif
+
   DEBUGASSERT((mem == NULL) || kmm_heapmember(mem));
   mm_free(g_kmmheap, mem);
 }
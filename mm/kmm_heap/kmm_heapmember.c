@@ -28,6 +28,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -52,6 +54,13 @@
 
 bool kmm_heapmember(FAR void *mem)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (kmm_large_member(mem))
+    {
+      return true;
+    }
+#endif
+
   return mm_heapmember(g_kmmheap, mem);
 }
 
@@ -0,0 +1,377 @@
+/****************************************************************************
+ * mm/kmm_heap/kmm_large.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <stdint.h>
+
+#include <nuttx/addrenv.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/kmap.h>
+#include <nuttx/mm/mm.h>
+
+#include "kmm_heap/kmm.h"
+
+#ifdef CONFIG_MM_HEAP_LARGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define KMM_LARGE_MAGIC    0x4b4c5247 /* "KLRG" */
+
+/* The smallest alignment of a large allocation */
+
+#define KMM_LARGE_ALIGN    (2 * sizeof(uintptr_t))
+
+#define KMM_LARGE_ALIGN_UP(a, align) \
+  (((a) + (align) - 1) & ~((align) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This header is at the start of the first page of a large allocation.
+ * The user memory follows it in the same page.
+ */
+
+struct kmm_large_s
+{
+  dq_entry_t node;                   /* Link in the list of allocations */
+  uint32_t magic;                    /* KMM_LARGE_MAGIC while mapped */
+  unsigned int npages;               /* Number of mapped pages */
+  FAR void *mem;                     /* The user memory */
+  size_t size;                       /* Usable size of the user memory */
+  FAR void **pages;                  /* Physical pages, in the kernel heap */
+  FAR struct kmm_large_s *flink;     /* Link in the delayed free list */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_kmm_large_lock;
+
+/* The large allocations that are mapped and not yet freed */
+
+static dq_queue_t g_kmm_large_list;
+
+/* Large allocations freed from interrupt handlers, which can't unmap */
+
+static FAR struct kmm_large_s *g_kmm_large_delay;
+
+/* Statistics */
+
+static size_t g_kmm_large_nbytes;
+static size_t g_kmm_large_count;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_large_release
+ *
+ * Description:
+ *   Unmap a large allocation and free its pages.
+ *
+ ****************************************************************************/
+
+static void kmm_large_release(FAR struct kmm_large_s *large)
+{
+  FAR void **pages = large->pages;
+  unsigned int npages = large->npages;
+  irqstate_t flags;
+  unsigned int i;
+
+  large->magic = 0;
+  kmm_unmap(large);
+
+  for (i = 0; i < npages; i++)
+    {
+      mm_pgfree((uintptr_t)pages[i], 1);
+    }
+
+  mm_free(g_kmmheap, pages);
+
+  flags = spin_lock_irqsave(&g_kmm_large_lock);
+  g_kmm_large_nbytes -= (size_t)npages << MM_PGSHIFT;
+  g_kmm_large_count--;
+  spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+}
+
+/****************************************************************************
+ * Name: kmm_large_free_delaylist
+ *
+ * Description:
+ *   Release the large allocations freed from interrupt handlers.
+ *
+ ****************************************************************************/
+
+static void kmm_large_free_delaylist(void)
+{
+  FAR struct kmm_large_s *large;
+  FAR struct kmm_large_s *next;
+  irqstate_t flags;
+
+  if (g_kmm_large_delay == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_kmm_large_lock);
+  large = g_kmm_large_delay;
+  g_kmm_large_delay = NULL;
+  spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+
+  for (; large != NULL; large = next)
+    {
+      next = large->flink;
+      kmm_large_release(large);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_large_memalign
+ *
+ * Description:
+ *   Map a large allocation from pages of the page allocator.  The pages
+ *   need not be physically contiguous, so large allocations neither
+ *   fragment the kernel heap nor depend on its fragmentation, and all of
+ *   their pages are returned when they are freed.
+ *
+ * Input Parameters:
+ *   alignment - The alignment of the user memory, 0 for the default
+ *   size      - Size (in bytes) of the memory region to be allocated.
+ *
+ * Returned Value:
+ *   The address of the allocated memory, or NULL if the allocation must be
+ *   left to the kernel heap.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_large_memalign(size_t alignment, size_t size)
+{
+  FAR struct kmm_large_s *large;
+  FAR void **pages;
+  unsigned int npages;
+  unsigned int i;
+  irqstate_t flags;
+  size_t offset;
+
+  /* Mapping pages needs a mutex */
+
+  if (up_interrupt_context())
+    {
+      return NULL;
+    }
+
+  kmm_large_free_delaylist();
+
+  /* The header and the user memory share the first page */
+
+  if (alignment < KMM_LARGE_ALIGN)
+    {
+      alignment = KMM_LARGE_ALIGN;
+    }
+
+  offset = KMM_LARGE_ALIGN_UP(sizeof(struct kmm_large_s), alignment);
+  if (offset >= MM_PGSIZE || size > SIZE_MAX - offset - MM_PGSIZE)
+    {
+      return NULL;
+    }
+
+  /* kmm_map() maps single pages directly, outside of the kmap area where
+   * kmm_large_member() looks for large allocations.
+   */
+
+  npages = MM_NPAGES(offset + size);
+  if (npages < 2 || npages > CONFIG_ARCH_KMAP_NPAGES)
+    {
+      return NULL;
+    }
+
+  pages = mm_malloc(g_kmmheap, npages * sizeof(FAR void *));
+  if (pages == NULL)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      pages[i] = (FAR void *)mm_pgalloc(1);
+      if (pages[i] == NULL)
+        {
+          goto errout_with_pages;
+        }
+    }
+
+  large = kmm_map(pages, npages, PROT_READ | PROT_WRITE);
+  if (large == NULL)
+    {
+      goto errout_with_pages;
+    }
+
+  large->magic  = KMM_LARGE_MAGIC;
+  large->npages = npages;
+  large->mem    = (FAR char *)large + offset;
+  large->size   = ((size_t)npages << MM_PGSHIFT) - offset;
+  large->pages  = pages;
+
+  flags = spin_lock_irqsave(&g_kmm_large_lock);
+  dq_addlast(&large->node, &g_kmm_large_list);
+  g_kmm_large_nbytes += (size_t)npages << MM_PGSHIFT;
+  g_kmm_large_count++;
+  spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+
+  return large->mem;
+
+errout_with_pages:
+  while (i-- > 0)
+    {
+      mm_pgfree((uintptr_t)pages[i], 1);
+    }
+
+  mm_free(g_kmmheap, pages);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: kmm_large_free
+ *
+ * Description:
+ *   Unmap a large allocation and return its pages to the page allocator.
+ *   Large allocations freed from interrupt handlers are released by the
+ *   next large allocation from a task.
+ *
+ ****************************************************************************/
+
+void kmm_large_free(FAR void *mem)
+{
+  FAR struct kmm_large_s *large;
+  irqstate_t flags;
+
+  DEBUGASSERT(kmm_large_member(mem));
+
+  large = (FAR struct kmm_large_s *)MM_PGALIGNDOWN(mem);
+
+  flags = spin_lock_irqsave(&g_kmm_large_lock);
+  dq_rem(&large->node, &g_kmm_large_list);
+
+  if (up_interrupt_context())
+    {
+      large->flink = g_kmm_large_delay;
+      g_kmm_large_delay = large;
+      spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+      return;
+    }
+
+  spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+  kmm_large_release(large);
+}
+
+/****************************************************************************
+ * Name: kmm_large_member
+ *
+ * Description:
+ *   Return true if 'mem' was returned by kmm_large_memalign().
+ *
+ ****************************************************************************/
+
+bool kmm_large_member(FAR void *mem)
+{
+  FAR struct kmm_large_s *large;
+  FAR dq_entry_t *node;
+  uintptr_t addr = (uintptr_t)mem;
+  irqstate_t flags;
+  bool found = false;
+
+  if (addr < CONFIG_ARCH_KMAP_VBASE || addr > ARCH_KMAP_VEND)
+    {
+      return false;
+    }
+
+  /* Other mappings share the kmap area, and the page of 'mem' need not be
+   * mapped at all.  Only the headers of the listed allocations are read.
+   */
+
+  large = (FAR struct kmm_large_s *)MM_PGALIGNDOWN(addr);
+
+  flags = spin_lock_irqsave(&g_kmm_large_lock);
+  for (node = dq_peek(&g_kmm_large_list); node != NULL; node = dq_next(node))
+    {
+      if (node == &large->node)
+        {
+          found = large->magic == KMM_LARGE_MAGIC && large->mem == mem;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_kmm_large_lock, flags);
+  return found;
+}
+
+/****************************************************************************
+ * Name: kmm_large_size
+ *
+ * Description:
+ *   Return the usable size of a large allocation.
+ *
+ ****************************************************************************/
+
+size_t kmm_large_size(FAR void *mem)
+{
+  DEBUGASSERT(kmm_large_member(mem));
+  return ((FAR struct kmm_large_s *)MM_PGALIGNDOWN(mem))->size;
+}
+
+/****************************************************************************
+ * Name: kmm_large_mallinfo
+ *
+ * Description:
+ *   Add the memory mapped for large allocations to the kernel heap
+ *   statistics.
+ *
+ ****************************************************************************/
+
+void kmm_large_mallinfo(FAR struct mallinfo *info)
+{
+  info->arena    += g_kmm_large_nbytes;
+  info->aordblks += g_kmm_large_count;
+  info->uordblks += g_kmm_large_nbytes;
+}
+
+#endif /* CONFIG_MM_HEAP_LARGE */
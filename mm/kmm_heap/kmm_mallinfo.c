@@ -26,6 +26,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -43,7 +45,14 @@
 
 struct mallinfo kmm_mallinfo(void)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  struct mallinfo info = mm_mallinfo(g_kmmheap);
+
+  kmm_large_mallinfo(&info);
+  return info;
+#else
   return mm_mallinfo(g_kmmheap);
+#endif
 }
 
 /****************************************************************************
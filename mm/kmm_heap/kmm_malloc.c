@@ -26,6 +26,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -48,6 +50,18 @@
 
 FAR void *kmm_malloc(size_t size)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (KMM_LARGE(size))
+    {
+      FAR void *mem = kmm_large_memalign(0, size);
+
+      if (mem != NULL)
+        {
+          return mem;
+        }
+    }
+#endif
+
   return mm_malloc(g_kmmheap, size);
 }
 
@@ -26,6 +26,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -34,6 +36,13 @@
 
 size_t kmm_malloc_size(FAR void *mem)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (mem != NULL && kmm_large_member(mem))
+    {
+      return kmm_large_size(mem);
+    }
+#endif
+
   return mm_malloc_size(g_kmmheap, mem);
 }
 
@@ -28,6 +28,8 @@
 
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -51,6 +53,18 @@
 
 FAR void *kmm_memalign(size_t alignment, size_t size)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (KMM_LARGE(size))
+    {
+      FAR void *mem = kmm_large_memalign(alignment, size);
+
+      if (mem != NULL)
+        {
+          return mem;
+        }
+    }
+#endif
+
   return mm_memalign(g_kmmheap, alignment, size);
 }
 
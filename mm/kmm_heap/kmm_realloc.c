@@ -24,8 +24,13 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+#include <sys/param.h>
+
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -49,6 +54,33 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  bool large = oldmem != NULL && kmm_large_member(oldmem);
+
+  if (large || (oldmem != NULL && KMM_LARGE(newsize)))
+    {
+      FAR void *newmem;
+      size_t oldsize;
+
+      oldsize = kmm_malloc_size(oldmem);
+      if (large && KMM_LARGE(newsize) && newsize <= oldsize)
+        {
+          return oldmem;
+        }
+
+      /* Move between the kernel heap and the pages, or to more pages */
+
+      newmem = kmm_malloc(newsize);
+      if (newmem != NULL)
+        {
+          memcpy(newmem, oldmem, MIN(oldsize, newsize));
+          kmm_free(oldmem);
+        }
+
+      return newmem;
+    }
+#endif
+
   return mm_realloc(g_kmmheap, oldmem, newsize);
 }
 
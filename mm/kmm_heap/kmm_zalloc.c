@@ -24,8 +24,12 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+
 #include <nuttx/mm/mm.h>
 
+#include "kmm_heap/kmm.h"
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 
 /****************************************************************************
@@ -48,6 +52,19 @@
 
 FAR void *kmm_zalloc(size_t size)
 {
+#ifdef CONFIG_MM_HEAP_LARGE
+  if (KMM_LARGE(size))
+    {
+      FAR void *mem = kmm_large_memalign(0, size);
+
+      if (mem != NULL)
+        {
+          memset(mem, 0, size);
+          return mem;
+        }
+    }
+#endif
+
   return mm_zalloc(g_kmmheap, size);
 }
 
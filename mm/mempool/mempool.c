@@ -42,6 +42,23 @@
 #undef  ALIGN_UP
 #define ALIGN_UP(x, a) (((x) + ((a) - 1)) & (~((a) - 1)))
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+/* Number of blocks moved between a cache and the pool at once */
+
+#  define MEMPOOL_CACHE_BATCH (CONFIG_MM_MEMPOOL_CACHE_DEPTH / 2)
+
+/* Pools with waiters must see every freed block, so they are not cached */
+
+#  define MEMPOOL_CACHEABLE(pool) (!(pool)->wait || (pool)->expandsize != 0)
+
+/* The shrinkers live in the kernel next to /proc/mempressure */
+
+#  if defined(CONFIG_MM_PRESSURE) && \
+      (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#    define MEMPOOL_SHRINKER
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -109,6 +126,278 @@ static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
 }
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+/****************************************************************************
+ * Name: mempool_cache_take
+ *
+ * Description:
+ *   Unlink up to 'n' blocks from the head of a cache.
+ *
+ * Assumptions:
+ *   Called with the cache locked.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_cache_take(FAR struct mempool_cache_s *cache,
+                                          size_t n)
+{
+  FAR sq_entry_t *head = cache->head;
+  FAR sq_entry_t *tail = head;
+  size_t i;
+
+  if (head == NULL || n == 0)
+    {
+      return NULL;
+    }
+
+  for (i = 1; i < n && tail->flink != NULL; i++)
+    {
+      tail = tail->flink;
+    }
+
+  cache->head  = tail->flink;
+  cache->count -= i;
+  tail->flink  = NULL;
+  return head;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_release
+ *
+ * Description:
+ *   Return a list of cached blocks to the free queue of the pool under a
+ *   single pool lock.
+ *
+ ****************************************************************************/
+
+static void mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR sq_entry_t *list)
+{
+  FAR sq_entry_t *next;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&pool->lock);
+
+  for (; list != NULL; list = next)
+    {
+      next = list->flink;
+      sq_addfirst(list, &pool->queue);
+      pool->nalloc--;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+
+/****************************************************************************
+ * Name: mempool_cache_alloc
+ *
+ * Description:
+ *   Take a block from the cache of this CPU, refilling an empty cache with
+ *   a batch of blocks from the free queue of the pool.  Returns NULL if the
+ *   allocation must be left to the slow path, which may expand the pool or
+ *   use the interrupt queue.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_cache_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *list = NULL;
+  FAR sq_entry_t *tail = NULL;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+  size_t n = 0;
+
+  if (!MEMPOOL_CACHEABLE(pool))
+    {
+      return NULL;
+    }
+
+  /* The lock is only contended by a flush, so it does not matter if we
+   * move to another CPU before it is taken.
+   */
+
+  cache = &pool->cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  blk = cache->head;
+  if (blk != NULL)
+    {
+      cache->head = blk->flink;
+      cache->count--;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (blk != NULL)
+    {
+      return blk;
+    }
+
+  /* The cache is empty, take one block for the caller and a batch for the
+   * cache.  Cached blocks are accounted as allocated in the pool.
+   */
+
+  flags = spin_lock_irqsave(&pool->lock);
+
+  while (n < MEMPOOL_CACHE_BATCH + 1 &&
+         (blk = mempool_remove_queue(&pool->queue)) != NULL)
+    {
+      blk->flink = list;
+      list       = blk;
+      if (tail == NULL)
+        {
+          tail = blk;
+        }
+
+      n++;
+    }
+
+  pool->nalloc += n;
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  if (list == NULL)
+    {
+      return NULL;
+    }
+
+  blk  = list;
+  list = list->flink;
+  if (list != NULL)
+    {
+      cache = &pool->cache[up_cpu_index()];
+      flags = spin_lock_irqsave(&cache->lock);
+      tail->flink  = cache->head;
+      cache->head  = list;
+      cache->count += n - 1;
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_free
+ *
+ * Description:
+ *   Put a free block into the cache of this CPU.  A cache holding more than
+ *   CONFIG_MM_MEMPOOL_CACHE_DEPTH blocks returns a batch of them to the
+ *   pool.  Returns false if the block must be returned to the pool instead.
+ *
+ ****************************************************************************/
+
+static bool mempool_cache_free(FAR struct mempool_s *pool,
+                               FAR sq_entry_t *blk)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *list = NULL;
+  irqstate_t flags;
+
+  /* Blocks of the interrupt queue must go back to it */
+
+  if (!MEMPOOL_CACHEABLE(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+  cache = &pool->cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  blk->flink  = cache->head;
+  cache->head = blk;
+  if (++cache->count > CONFIG_MM_MEMPOOL_CACHE_DEPTH)
+    {
+      list = mempool_cache_take(cache, MEMPOOL_CACHE_BATCH);
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (list != NULL)
+    {
+      mempool_cache_release(pool, list);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_flush
+ *
+ * Description:
+ *   Return the blocks cached by all CPUs to the pool.  Returns the number
+ *   of blocks returned.
+ *
+ ****************************************************************************/
+
+static size_t mempool_cache_flush(FAR struct mempool_s *pool)
+{
+  size_t ret = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct mempool_cache_s *cache = &pool->cache[i];
+      FAR sq_entry_t *list;
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&cache->lock);
+      ret  += cache->count;
+      list  = mempool_cache_take(cache, cache->count);
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (list != NULL)
+        {
+          mempool_cache_release(pool, list);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_shrink
+ *
+ * Description:
+ *   The shrinker of a pool, see mm_register_shrinker().  The blocks go
+ *   back to the pool, not to the heap, so 0 is returned; the flush only
+ *   keeps blocks from sitting idle in the caches of other CPUs while the
+ *   system is short of memory.
+ *
+ ****************************************************************************/
+
+#ifdef MEMPOOL_SHRINKER
+static size_t mempool_cache_shrink(FAR void *arg, int level)
+{
+  mempool_cache_flush(arg);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: mempool_cache_count
+ *
+ * Description:
+ *   Return the number of blocks cached by all CPUs.  The result is a
+ *   snapshot that may be stale by the time it is used.
+ *
+ ****************************************************************************/
+
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      count += pool->cache[i].count;
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -133,6 +422,9 @@ static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
@@ -187,6 +479,24 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
     }
 
   spin_initialize(&pool->lock, SP_UNLOCKED);
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_initialize(&pool->cache[i].lock, SP_UNLOCKED);
+      pool->cache[i].head  = NULL;
+      pool->cache[i].count = 0;
+    }
+
+#  ifdef MEMPOOL_SHRINKER
+  if (MEMPOOL_CACHEABLE(pool))
+    {
+      pool->shrinker.shrink = mempool_cache_shrink;
+      pool->shrinker.arg    = pool;
+      mm_register_shrinker(&pool->shrinker);
+    }
+#  endif
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -224,6 +534,18 @@ FAR void *mempool_alloc(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  blk = mempool_cache_alloc(pool);
+  if (blk != NULL)
+    {
+#  ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(blk, 0xaa, pool->blocksize);
+#  endif
+      kasan_unpoison(blk, pool->blocksize);
+      return blk;
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(&pool->queue);
@@ -251,6 +573,15 @@ retry:
 
               if (base == NULL)
                 {
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+                  /* Blocks cached by other CPUs may serve us instead */
+
+                  if (mempool_cache_flush(pool))
+                    {
+                      goto retry;
+                    }
+#endif
+
                   return NULL;
                 }
 
@@ -261,6 +592,12 @@ retry:
                          &pool->equeue);
               blk = mempool_remove_queue(&pool->queue);
             }
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+          else if (!pool->wait && mempool_cache_flush(pool))
+            {
+              goto retry;
+            }
+#endif
           else if (!pool->wait ||
                    nxsem_wait_uninterruptible(&pool->waitsem) < 0)
             {
@@ -302,8 +639,22 @@ out_with_lock:
 
 void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  irqstate_t flags;
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+#  ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, 0x55, pool->blocksize);
+#  endif
+
+  kasan_poison(blk, pool->blocksize);
+  if (mempool_cache_free(pool, blk))
+    {
+      return;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -369,6 +720,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  size_t count;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
@@ -379,6 +733,13 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->aordblks = list_length(&pool->alist);
 #else
   info->aordblks = pool->nalloc;
+#endif
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  /* Cached blocks are free, but accounted as allocated in the pool */
+
+  count = mempool_cache_count(pool);
+  info->ordblks  += count;
+  info->aordblks -= count;
 #endif
   info->arena =
     mempool_queue_lenth(&pool->equeue) * sizeof(sq_entry_t) +
@@ -420,14 +781,22 @@ mempool_info_task(FAR struct mempool_s *pool,
       size_t count = mempool_queue_lenth(&pool->queue) +
                      mempool_queue_lenth(&pool->iqueue);
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+      count += mempool_cache_count(pool);
+#endif
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE < 0
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#  ifdef CONFIG_MM_MEMPOOL_CACHE
+      count -= mempool_cache_count(pool);
+#  endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #else
   else
@@ -480,6 +849,9 @@ void mempool_memdump(FAR struct mempool_s *pool,
   if (dump->pid == PID_MM_FREE)
     {
       FAR sq_entry_t *entry;
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+      int i;
+#endif
 
       sq_for_every(&pool->queue, entry)
         {
@@ -492,6 +864,17 @@ void mempool_memdump(FAR struct mempool_s *pool,
           syslog(LOG_INFO, "%12zu%*p\n",
                  blocksize, MM_PTR_FMT_WIDTH, (FAR char *)entry);
         }
+
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          for (entry = pool->cache[i].head; entry; entry = entry->flink)
+            {
+              syslog(LOG_INFO, "%12zu%*p\n",
+                     blocksize, MM_PTR_FMT_WIDTH, (FAR char *)entry);
+            }
+        }
+#endif
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -545,6 +928,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef CONFIG_MM_MEMPOOL_CACHE
+  mempool_cache_flush(pool);
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
   if (!list_is_empty(&pool->alist))
 #else
@@ -554,6 +941,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
       return -EBUSY;
     }
 
+#ifdef MEMPOOL_SHRINKER
+  mm_unregister_shrinker(&pool->shrinker);
+#endif
+
   if (pool->initialsize >= blocksize + sizeof(sq_entry_t))
     {
       count = (pool->initialsize - sizeof(sq_entry_t)) / blocksize;
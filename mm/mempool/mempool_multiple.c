@@ -41,6 +41,10 @@
 #undef  ALIGN_DOWN
 #define ALIGN_DOWN(x, a)      ((size_t)(x) & (~((a) - 1)))
 
+/* The maximum number of entries of the size index */
+
+#define MEMPOOL_MULTIPLE_INDEX_MAX 256
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -79,14 +83,14 @@ struct mempool_multiple_s
   mempool_multiple_free_t       free;        /* The free function for mempool */
   size_t                        alloced;     /* Total size of alloc */
 
-  /* This delta describes the relationship between the block size of each
-   * mempool in multiple mempool by user initialized. It is automatically
-   * detected by the mempool_multiple_init function. If the delta is not
-   * equal to 0, the block size of the pool in the multiple mempool is an
-   * arithmetic progressions, otherwise it is an increasing progressions.
+  /* The size index maps a size rounded up to a multiple of
+   * (1 << index_shift) to the first pool whose blocks may hold it, so
+   * that the pool of a size is found without searching.  It is NULL if
+   * there are too many pools to index.
    */
 
-  size_t                        delta;
+  FAR uint8_t                  *index;
+  size_t                        index_shift;
 
   /* It is used to record the information recorded by the mempool during
    * expansion, and find the mempool by adding an index
@@ -118,22 +122,29 @@ mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
     }
 
   right = mpool->npools;
-  if (mpool->delta != 0)
+  if (size > mpool->pools[right - 1].blocksize)
+    {
+      return NULL;
+    }
+
+  if (mpool->index != NULL)
     {
-      left = mpool->pools[0].blocksize;
-      if (left >= size)
+      /* An index entry may cover the block sizes of a few pools */
+
+      left = mpool->index[(size + (1 << mpool->index_shift) - 1) >>
+                          mpool->index_shift];
+      while (mpool->pools[left].blocksize < size)
         {
-          return &mpool->pools[0];
+          left++;
         }
 
-      mid = (size - left + mpool->delta - 1) / mpool->delta;
-      return mid < right ? &mpool->pools[mid] : NULL;
+      return &mpool->pools[left];
     }
 
   while (left < right)
     {
       mid = (left + right) >> 1;
-      if (mpool->pools[mid].blocksize > size)
+      if (mpool->pools[mid].blocksize >= size)
         {
           right = mid;
         }
@@ -143,11 +154,6 @@ mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
         }
     }
 
-  if (left == mpool->npools)
-    {
-      return NULL;
-    }
-
   return &mpool->pools[left];
 }
 
@@ -235,6 +241,66 @@ mempool_multiple_free_chunk(FAR struct mempool_multiple_s *mpool,
   nxrmutex_unlock(&mpool->lock);
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_init_index
+ *
+ * Description:
+ *   Build the size index of a multiple mempool.  The granularity of the
+ *   index is the largest power of two that divides all block sizes, made
+ *   coarser until the index has at most MEMPOOL_MULTIPLE_INDEX_MAX entries.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_init_index(FAR struct mempool_multiple_s *mpool)
+{
+  size_t maxsize = mpool->pools[mpool->npools - 1].blocksize;
+  size_t sizes = 0;
+  size_t nindex;
+  size_t pool;
+  size_t i;
+
+  mpool->index = NULL;
+  if (mpool->npools > UINT8_MAX + 1)
+    {
+      return;
+    }
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      sizes |= mpool->pools[i].blocksize;
+    }
+
+  mpool->index_shift = ffsl(sizes) - 1;
+  while ((maxsize >> mpool->index_shift) + 1 > MEMPOOL_MULTIPLE_INDEX_MAX)
+    {
+      mpool->index_shift++;
+    }
+
+  nindex = (maxsize >> mpool->index_shift) + 1;
+  mpool->index = mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
+                                              nindex);
+  if (mpool->index == NULL)
+    {
+      return;
+    }
+
+  /* Entry i covers the sizes ((i - 1) << shift, i << shift] and points to
+   * the first pool with blocks larger than the lower end.
+   */
+
+  for (i = 0, pool = 0; i < nindex; i++)
+    {
+      size_t lower = i == 0 ? 0 : ((i - 1) << mpool->index_shift) + 1;
+
+      while (mpool->pools[pool].blocksize < lower)
+        {
+          pool++;
+        }
+
+      mpool->index[i] = pool;
+    }
+}
+
 static FAR void *mempool_multiple_alloc_callback(FAR struct mempool_s *pool,
                                                  size_t size)
 {
@@ -348,8 +414,8 @@ mempool_multiple_get_dict(FAR struct mempool_multiple_s *mpool,
  *   interruptsize, wait. These mempool will be initialized by mempool_init.
  *   The name of all mempool are "name".
  *
- *   This function will initialize the member delta by detecting the
- *   relationship between the each block size of mempool in multiple mempool.
+ *   This function will build an index from the size of an allocation to
+ *   the mempool serving it.  The block sizes must be increasing.
  *
  * Input Parameters:
  *   name            - The name of memory pool.
@@ -428,7 +494,7 @@ mempool_multiple_init(FAR const char *name,
   mpool->pools = pools;
   mpool->npools = npools;
   mpool->minpoolsize = minpoolsize;
-  mpool->delta = 0;
+  mpool->index = NULL;
 
   for (i = 0; i < npools; i++)
     {
@@ -444,22 +510,10 @@ mempool_multiple_init(FAR const char *name,
         {
           goto err_with_pools;
         }
-
-      if (i + 1 != npools)
-        {
-          size_t delta = poolsize[i + 1] - poolsize[i];
-
-          if (i == 0)
-            {
-              mpool->delta = delta;
-            }
-          else if (delta != mpool->delta)
-            {
-              mpool->delta = 0;
-            }
-        }
     }
 
+  mempool_multiple_init_index(mpool);
+
   mpool->dict_used = 0;
   mpool->dict_col_num_log2 = fls(dict_expendsize /
                                  sizeof(struct mpool_dict_s));
@@ -485,6 +539,11 @@ err_with_pools:
       mempool_deinit(pools + i);
     }
 
+  if (mpool->index != NULL)
+    {
+      mempool_multiple_free_chunk(mpool, mpool->index);
+    }
+
   mempool_multiple_free_chunk(mpool, pools);
 err_with_mpool:
   free(arg, mpool);
@@ -847,6 +906,11 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
     }
 
   mempool_multiple_free_chunk(mpool, mpool->dict);
+  if (mpool->index != NULL)
+    {
+      mempool_multiple_free_chunk(mpool, mpool->index);
+    }
+
   mempool_multiple_free_chunk(mpool, mpool->pools);
   nxrmutex_destroy(&mpool->lock);
   mpool->free(mpool, mpool);
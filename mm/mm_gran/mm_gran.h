@@ -42,8 +42,19 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_FULL(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_FULL(n) - 1))
+
+/* The summary bitmap follows the GAT.  It holds one bit per GAT entry that
+ * is set while all granules of the entry are allocated, so that searches
+ * skip 32 full entries with one test.
+ */
+
+#define GRAN_FULL(priv) \
+  (&(priv)->gat[SIZEOF_GAT((priv)->ngranules)])
 
 /* Debug */
 
@@ -73,6 +84,7 @@ struct gran_s
 #else
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
+  uint16_t   hint;      /* The granule where the next search starts */
   uintptr_t  heapstart; /* The aligned start of the granule heap */
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
@@ -119,4 +131,23 @@ void gran_leave_critical(FAR struct gran_s *priv);
 FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                               unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of allocated granules as free.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The number of the first granule.
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules);
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * mm/mm_gran/mm_gran_test.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Benchmark driver.  Like mm/iob/iob_test.c, this is not part of any build.
+ * It measures the time of gran_alloc() and gran_free() against the
+ * fragmentation of the granule heap, and requires a custom build setup
+ * that links it with the mm_gran sources on the host, for example with
+ * stubs for kmm_zalloc() and the gran critical section.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <nuttx/mm/gran.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOG2GRAN  6                      /* 64 byte granules */
+#define NGRANULES 65504                  /* Nearly 4 MiB of heap */
+#define HEAPSIZE  (NGRANULES << LOG2GRAN)
+#define MAXALLOC  64                     /* Largest allocation in granules */
+#define NSLOTS    (NGRANULES / 2)
+#define NLOOPS    100000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct slot_s
+{
+  FAR void *mem;
+  size_t size;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint64_t g_heap[HEAPSIZE / sizeof(uint64_t)];
+static struct slot_s g_slots[NSLOTS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static size_t random_size(void)
+{
+  return ((size_t)(rand() % MAXALLOC) + 1) << LOG2GRAN;
+}
+
+/* Allocate random sizes until 'percent' of the heap is in use, freeing
+ * every other allocation on the way to leave holes behind.
+ */
+
+static int fragment(GRAN_HANDLE handle, int percent)
+{
+  struct graninfo_s info;
+  int nslots = 0;
+  int i;
+
+  for (; ; )
+    {
+      gran_info(handle, &info);
+      if ((NGRANULES - info.nfree) * 100 >= NGRANULES * percent ||
+          nslots >= NSLOTS)
+        {
+          break;
+        }
+
+      g_slots[nslots].size = random_size();
+      g_slots[nslots].mem  = gran_alloc(handle, g_slots[nslots].size);
+      if (g_slots[nslots].mem == NULL)
+        {
+          break;
+        }
+
+      /* Free one of the earlier allocations from time to time */
+
+      if (++nslots > 1 && (rand() & 3) == 0)
+        {
+          i = rand() % (nslots - 1);
+          gran_free(handle, g_slots[i].mem, g_slots[i].size);
+          g_slots[i] = g_slots[--nslots];
+        }
+    }
+
+  return nslots;
+}
+
+static void benchmark(GRAN_HANDLE handle, int percent)
+{
+  struct graninfo_s info;
+  uint64_t talloc = 0;
+  uint64_t tfree = 0;
+  uint64_t start;
+  int nslots;
+  int nfail = 0;
+  int i;
+
+  nslots = fragment(handle, percent);
+  gran_info(handle, &info);
+
+  for (i = 0; i < NLOOPS; i++)
+    {
+      size_t size = random_size();
+      FAR void *mem;
+
+      start   = now_ns();
+      mem     = gran_alloc(handle, size);
+      talloc += now_ns() - start;
+
+      if (mem == NULL)
+        {
+          nfail++;
+          continue;
+        }
+
+      start  = now_ns();
+      gran_free(handle, mem, size);
+      tfree += now_ns() - start;
+    }
+
+  printf("%3d%% used, %5u free, %5u max run: "
+         "alloc %6.1f ns, free %6.1f ns, %d failed\n",
+         percent, info.nfree, info.mxfree,
+         (double)talloc / NLOOPS, (double)tfree / (NLOOPS - nfail), nfail);
+
+  for (i = 0; i < nslots; i++)
+    {
+      gran_free(handle, g_slots[i].mem, g_slots[i].size);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ *
+ * Description:
+ *   A simple benchmark for the granule allocator
+ *
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  static const int percent[] =
+  {
+    0, 25, 50, 75, 90, 95
+  };
+
+  GRAN_HANDLE handle;
+  int i;
+
+  handle = gran_initialize(g_heap, sizeof(g_heap), LOG2GRAN, LOG2GRAN);
+  if (handle == NULL)
+    {
+      fprintf(stderr, "gran_initialize failed\n");
+      return EXIT_FAILURE;
+    }
+
+  srand(1);
+  for (i = 0; i < sizeof(percent) / sizeof(percent[0]); i++)
+    {
+      benchmark(handle, percent[i]);
+    }
+
+  gran_release(handle);
+  return EXIT_SUCCESS;
+}
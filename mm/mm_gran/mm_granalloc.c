@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <strings.h>
 
 #include <nuttx/mm/gran.h>
 
@@ -32,6 +33,136 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_next_free
+ *
+ * Description:
+ *   Return the first free granule at or after 'granno', or the number of
+ *   granules if there is none.  GAT entries that are full are skipped 32 at
+ *   a time using the summary bitmap.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_next_free(FAR struct gran_s *priv,
+                                   unsigned int granno)
+{
+  FAR uint32_t *full = GRAN_FULL(priv);
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  unsigned int gatidx = granno >> 5;
+  uint32_t     bits;
+
+  if (granno >= priv->ngranules)
+    {
+      return priv->ngranules;
+    }
+
+  /* Free granules in the rest of the first GAT entry */
+
+  bits = ~priv->gat[gatidx] & (0xffffffff << (granno & 31));
+  while (bits == 0)
+    {
+      /* Find the next GAT entry that is not full */
+
+      if (++gatidx >= ngat)
+        {
+          return priv->ngranules;
+        }
+
+      bits = ~full[gatidx >> 5] & (0xffffffff << (gatidx & 31));
+      while (bits == 0)
+        {
+          gatidx = (gatidx + 32) & ~31;
+          if (gatidx >= ngat)
+            {
+              return priv->ngranules;
+            }
+
+          bits = ~full[gatidx >> 5];
+        }
+
+      gatidx = (gatidx & ~31) + ffs(bits) - 1;
+      if (gatidx >= ngat)
+        {
+          return priv->ngranules;
+        }
+
+      bits = ~priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + ffs(bits) - 1;
+  return granno < priv->ngranules ? granno : priv->ngranules;
+}
+
+/****************************************************************************
+ * Name: gran_next_used
+ *
+ * Description:
+ *   Return the first allocated granule at or after 'granno' and before
+ *   'end', or 'end' if there is none.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_next_used(FAR struct gran_s *priv,
+                                   unsigned int granno, unsigned int end)
+{
+  unsigned int gatidx = granno >> 5;
+  uint32_t     bits;
+
+  bits = priv->gat[gatidx] & (0xffffffff << (granno & 31));
+  while (bits == 0)
+    {
+      if ((++gatidx << 5) >= end)
+        {
+          return end;
+        }
+
+      bits = priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + ffs(bits) - 1;
+  return granno < end ? granno : end;
+}
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find 'ngranules' contiguous free granules between the granules 'start'
+ *   and 'end'.  Returns the first granule of the run or -1.
+ *
+ ****************************************************************************/
+
+static int gran_search(FAR struct gran_s *priv, unsigned int ngranules,
+                       unsigned int start, unsigned int end)
+{
+  unsigned int used;
+
+  while (start + ngranules <= end)
+    {
+      start = gran_next_free(priv, start);
+      if (start + ngranules > end)
+        {
+          break;
+        }
+
+      /* Is the run long enough?  If not, continue after its end. */
+
+      used = gran_next_used(priv, start, start + ngranules);
+      if (used == start + ngranules)
+        {
+          return start;
+        }
+
+      start = used + 1;
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -40,11 +171,9 @@
  * Name: gran_alloc
  *
  * Description:
- *   Allocate memory from the granule heap.
- *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   Allocate memory from the granule heap.  The search for free granules
+ *   starts where the previous allocation ended (next fit) and wraps around
+ *   to the start of the heap.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -59,22 +188,26 @@
 FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
-  unsigned int ngranules;
+  FAR void    *alloc = NULL;
   size_t       tmpmask;
-  uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
+  size_t       ngranules;
+  unsigned int hint;
+  int          granno;
   int          ret;
 
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL);
 
   if (priv != NULL && size > 0)
     {
+      /* How many contiguous granules we we need to find? */
+
+      tmpmask   = ((size_t)1 << priv->log2gran) - 1;
+      ngranules = (size >> priv->log2gran) + ((size & tmpmask) != 0);
+      if (ngranules > priv->ngranules)
+        {
+          return NULL;
+        }
+
       /* Get exclusive access to the GAT */
 
       ret = gran_enter_critical(priv);
@@ -83,168 +216,37 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
           return NULL;
         }
 
-      /* How many contiguous granules we we need to find? */
-
-      tmpmask   = (1 << priv->log2gran) - 1;
-      ngranules = (size + tmpmask) >> priv->log2gran;
-
-      /* Then create mask for that number of granules */
-
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
-
-      /* Now search the granule allocation table for that number
-       * of contiguous
+      /* Search from the hint to the end of the heap, then from the start
+       * of the heap to the hint.
        */
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      hint   = priv->hint;
+      granno = gran_search(priv, ngranules, hint, priv->ngranules);
+      if (granno < 0 && hint > 0)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
-
-          if (curr == 0xffffffff)
-            {
-              continue;
-            }
-
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx + 32 < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
+          hint  += ngranules - 1;
+          granno = gran_search(priv, ngranules, 0,
+                               hint < priv->ngranules ?
+                               hint : priv->ngranules);
+        }
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
+      if (granno >= 0)
+        {
+          /* Mark these granules allocated */
 
-          else
-            {
-              next = 0xffffffff;
-            }
+          alloc = gran_mark_allocated(priv, priv->heapstart +
+                                      ((uintptr_t)granno << priv->log2gran),
+                                      ngranules);
+          DEBUGASSERT(alloc != NULL);
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          alloc = priv->heapstart + (granidx << priv->log2gran);
-
-          for (bitidx = 0;
-               bitidx < 32 &&
-               (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Check if we have the allocation at this
-               * bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          granno += ngranules;
+          priv->hint = granno < priv->ngranules ? granno : 0;
         }
 
       gran_leave_critical(priv);
     }
 
-  return NULL;
+  return alloc;
 }
 
 #endif /* CONFIG_GRAN */
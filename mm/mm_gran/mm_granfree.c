@@ -56,15 +56,11 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
   unsigned int granno;
-  unsigned int gatidx;
-  unsigned int gatbit;
   unsigned int granmask;
   unsigned int ngranules;
-  unsigned int avail;
-  uint32_t     gatmask;
   int          ret;
 
-  DEBUGASSERT(priv != NULL && memory && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL && memory && size > 0);
 
   /* Get exclusive access to the GAT */
 
@@ -84,52 +80,14 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
 
   granno = ((uintptr_t)memory - priv->heapstart) >> priv->log2gran;
 
-  /* Determine the GAT table index and bit number associated with the
-   * allocation.
-   */
-
-  gatidx = granno >> 5;
-  gatbit = granno & 31;
-
   /* Determine the number of granules in the allocation */
 
   granmask =  (1 << priv->log2gran) - 1;
   ngranules = (size + granmask) >> priv->log2gran;
 
-  /* Clear bits in the GAT entry or entries */
-
-  avail = 32 - gatbit;
-  if (ngranules > avail)
-    {
-      /* Clear bits in the first GAT entry */
-
-      gatmask = (0xffffffff << gatbit);
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
-      priv->gat[gatidx] &= ~gatmask;
-      ngranules -= avail;
-
-      /* Clear bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx + 1] & gatmask) == gatmask);
-
-      priv->gat[gatidx + 1] &= ~gatmask;
-    }
-
-  /* Handle the case where where all of the granules came from one entry */
-
-  else
-    {
-      /* Clear bits in a single GAT entry */
-
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
-      priv->gat[gatidx] &= ~gatmask;
-    }
+  /* Clear bits in the GAT entries */
 
+  gran_mark_free(priv, granno, ngranules);
   gran_leave_critical(priv);
 }
 
@@ -32,6 +32,28 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_gatmask
+ *
+ * Description:
+ *   Return the mask of the granules of a range that fall into the GAT entry
+ *   of its first granule, and the number of those granules in *nbits.
+ *
+ ****************************************************************************/
+
+static uint32_t gran_gatmask(unsigned int gatbit, unsigned int ngranules,
+                             FAR unsigned int *nbits)
+{
+  unsigned int avail = 32 - gatbit;
+
+  *nbits = ngranules < avail ? ngranules : avail;
+  return (0xffffffff >> (32 - *nbits)) << gatbit;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,66 +78,87 @@
 FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                               unsigned int ngranules)
 {
+  FAR uint32_t *full = GRAN_FULL(priv);
   unsigned int granno;
   unsigned int gatidx;
-  unsigned int gatbit;
-  unsigned int avail;
+  unsigned int nbits;
+  unsigned int n;
   uint32_t     gatmask;
 
+  DEBUGASSERT(ngranules > 0);
+
   /* Determine the granule number of the allocation */
 
   granno = (alloc - priv->heapstart) >> priv->log2gran;
-
-  /* Determine the GAT table index associated with the allocation */
-
-  gatidx = granno >> 5;
-  gatbit = granno & 31;
-
-  /* Mark bits in the GAT entry or entries */
-
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  if (granno + ngranules > priv->ngranules)
     {
-      uint32_t gatmask2;
-
-      gatmask    = 0xffffffff << gatbit;
-      ngranules -= avail;
-      gatmask2   = 0xffffffff >> (32 - ngranules);
+      return NULL;
+    }
 
-      /* Check that the area is free, from both mask words */
+  /* Check that the area is free, from all GAT entries */
 
-      if (((priv->gat[gatidx] & gatmask) != 0) ||
-          ((priv->gat[gatidx + 1] & gatmask2) != 0))
+  for (n = ngranules, gatidx = granno >> 5; n > 0; n -= nbits, gatidx++)
+    {
+      gatmask = gran_gatmask(n == ngranules ? granno & 31 : 0, n, &nbits);
+      if ((priv->gat[gatidx] & gatmask) != 0)
         {
           return NULL;
         }
+    }
 
-      /* Mark bits in the first and second GAT entry */
+  /* Mark bits in the GAT entries, and the entries that became full in the
+   * summary bitmap
+   */
 
+  for (n = ngranules, gatidx = granno >> 5; n > 0; n -= nbits, gatidx++)
+    {
+      gatmask = gran_gatmask(n == ngranules ? granno & 31 : 0, n, &nbits);
       priv->gat[gatidx] |= gatmask;
-      priv->gat[gatidx + 1] |= gatmask2;
+
+      if (priv->gat[gatidx] == 0xffffffff)
+        {
+          full[gatidx >> 5] |= 1u << (gatidx & 31);
+        }
     }
 
-  /* Handle the case where where all of the granules come from one entry */
+  return (FAR void *)alloc;
+}
 
-  else
-    {
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of allocated granules as free.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The number of the first granule.
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      /* Check that the area is free */
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules)
+{
+  FAR uint32_t *full = GRAN_FULL(priv);
+  unsigned int gatidx;
+  unsigned int nbits;
+  unsigned int n;
+  uint32_t     gatmask;
 
-      if ((priv->gat[gatidx] & gatmask) != 0)
-        {
-          return NULL;
-        }
+  DEBUGASSERT(ngranules > 0 && granno + ngranules <= priv->ngranules);
 
-      /* Mark bits in a single GAT entry */
+  for (n = ngranules, gatidx = granno >> 5; n > 0; n -= nbits, gatidx++)
+    {
+      gatmask = gran_gatmask(n == ngranules ? granno & 31 : 0, n, &nbits);
+      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
-      priv->gat[gatidx] |= gatmask;
+      priv->gat[gatidx]  &= ~gatmask;
+      full[gatidx >> 5] &= ~(1u << (gatidx & 31));
     }
-
-  return (FAR void *)alloc;
 }
 
 #endif /* CONFIG_GRAN */
@@ -29,6 +29,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -56,10 +57,13 @@
  *   quantization losses.
  *
  * MM_MAX_SHIFT is used to define MM_MAX_CHUNK
- * MM_MAX_CHUNK is the largest, contiguous chunk of memory that can be
- *   allocated.  It can range from 16-bytes to 4Gb.  Larger values of
- *   MM_MAX_SHIFT can cause larger data structure sizes and, perhaps,
- *   minor performance losses.
+ * MM_MAX_CHUNK is the largest chunk that is kept in a size class of its
+ *   own.  All larger free chunks share one list that has to be searched.
+ *   Larger values of MM_MAX_SHIFT cause larger data structure sizes.
+ *
+ * MM_SL_SHIFT splits each power-of-two range of sizes into 2^MM_SL_SHIFT
+ *   size classes, each holding an unordered list of free chunks.  A bitmap
+ *   of non-empty classes gives an O(1) search for a fitting chunk.
  */
 
 #define MM_MIN_SHIFT      LOG2_CEIL(sizeof(struct mm_freenode_s))
@@ -68,6 +72,7 @@
 #else
 #  define MM_MAX_SHIFT    (22)  /*  4 Mb */
 #endif
+#define MM_SL_SHIFT       (3)   /* 8 classes per power of two */
 
 #if CONFIG_MM_BACKTRACE == 0
 #  define MM_ADD_BACKTRACE(heap, ptr) \
@@ -110,7 +115,9 @@
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
-#define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#define MM_NSL           (1 << MM_SL_SHIFT)
+#define MM_NFL           (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#define MM_NNODES        (((MM_NFL - 1) << MM_SL_SHIFT) + 1)
 
 #if CONFIG_MM_DFAULT_ALIGNMENT == 0
 #  define MM_ALIGN       (2 * sizeof(uintptr_t))
@@ -157,6 +164,78 @@
 #define MM_PREVNODE_IS_ALLOC(node) (((node)->size & MM_PREVFREE_BIT) == 0)
 #define MM_PREVNODE_IS_FREE(node) (((node)->size & MM_PREVFREE_BIT) != 0)
 
+/* The per-CPU chunk cache runs with local interrupts disabled, so it is
+ * only available to heaps managed by the kernel.
+ */
+
+#if defined(CONFIG_MM_HEAP_CACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_CACHE
+#endif
+
+#ifdef CONFIG_MM_HEAP_CACHE
+#  define MM_CACHE_NBINS (CONFIG_MM_HEAP_CACHE_MAXSIZE / MM_ALIGN)
+#endif
+
+/* The sampling heap profiler lives in the kernel next to /proc/heapprof.
+ * It only profiles the default user heap and the kernel heap.
+ */
+
+#if defined(CONFIG_MM_HEAPPROF) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAPPROF_MALLOC(heap, mem, size) \
+     do \
+       { \
+         if (MM_INTERNAL_HEAP(heap)) \
+           { \
+             mm_heapprof_malloc(mem, size); \
+           } \
+       } \
+     while (0)
+#  define MM_HEAPPROF_FREE(heap, mem) \
+     do \
+       { \
+         if (MM_INTERNAL_HEAP(heap)) \
+           { \
+             mm_heapprof_free(mem); \
+           } \
+       } \
+     while (0)
+#  define MM_HEAPPROF_MOVE(heap, oldmem, newmem, size) \
+     do \
+       { \
+         if (MM_INTERNAL_HEAP(heap)) \
+           { \
+             mm_heapprof_move(oldmem, newmem, size); \
+           } \
+       } \
+     while (0)
+#else
+#  define MM_HEAPPROF_MALLOC(heap, mem, size)
+#  define MM_HEAPPROF_FREE(heap, mem)
+#  define MM_HEAPPROF_MOVE(heap, oldmem, newmem, size)
+#endif
+
+/* The pressure level is tracked by the kernel next to /proc/mempressure */
+
+#if defined(CONFIG_MM_PRESSURE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_PRESSURE
+#  define MM_PRESSURE_UPDATE(heap) mm_pressure_update(heap)
+#else
+#  define MM_PRESSURE_UPDATE(heap)
+#endif
+
+/* A reallocation is profiled as a free followed by an allocation */
+
+#define MM_HEAPPROF_REALLOC(heap, oldmem, newmem, size) \
+  do \
+    { \
+      MM_HEAPPROF_FREE(heap, oldmem); \
+      MM_HEAPPROF_MALLOC(heap, newmem, size); \
+    } \
+  while (0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -216,6 +295,23 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+#ifdef CONFIG_MM_HEAP_CACHE
+/* Chunks of one size cached by one CPU, linked through their user memory */
+
+struct mm_cachebin_s
+{
+  FAR struct mm_delaynode_s *head;
+  size_t count;
+};
+
+struct mm_cache_s
+{
+  struct mm_cachebin_s bins[MM_CACHE_NBINS];
+  size_t nbytes;                            /* Size of all cached chunks */
+  spinlock_t lock;                          /* Taken by the owner or a flush */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -247,12 +343,20 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
-  /* All free nodes are maintained in a doubly linked list.  This
-   * array provides some hooks into the list at various points to
-   * speed searches for free nodes.
+  /* Free nodes are maintained in one doubly linked list per size class,
+   * see mm_size2ndx().
+   */
+
+  FAR struct mm_freenode_s *mm_nodelist[MM_NNODES];
+
+  /* Bitmaps of the non-empty size classes in mm_nodelist[]: bit 'fl' of
+   * mm_flmap is set if mm_slmap[fl] is not zero, and bit 'sl' of
+   * mm_slmap[fl] is set if mm_nodelist[(fl << MM_SL_SHIFT) + sl] is not
+   * empty.
    */
 
-  struct mm_freenode_s mm_nodelist[MM_NNODES];
+  uint32_t mm_flmap;
+  uint32_t mm_slmap[MM_NFL];
 
   /* Free delay list, for some situations where we can't do free
    * immdiately.
@@ -264,12 +368,30 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Per-CPU caches of small chunks */
+
+#ifdef CONFIG_MM_HEAP_CACHE
+  struct mm_cache_s mm_cache[CONFIG_SMP_NCPUS];
+#  ifdef CONFIG_MM_PRESSURE
+  struct mm_shrinker_s mm_shrinker;
+#  endif
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   FAR struct mempool_multiple_s *mm_mpool;
 #endif
 
+  /* Free bytes at or below which the heap is under low and critical
+   * pressure (0 for the default percentage), and its current level.
+   */
+
+#ifdef CONFIG_MM_PRESSURE
+  size_t mm_watermark[2];
+  uint8_t mm_pressure;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
@@ -298,6 +420,8 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
 
 /* Functions contained in mm_size2ndx.c *************************************/
 
@@ -308,8 +432,41 @@ int mm_size2ndx(size_t size);
 void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
                 FAR void *arg);
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize);
+
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef MM_HEAP_CACHE
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_cache_flush(FAR struct mm_heap_s *heap);
+struct mallinfo mm_cache_mallinfo(FAR struct mm_heap_s *heap);
+#  ifdef MM_PRESSURE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+void mm_cache_uninitialize(FAR struct mm_heap_s *heap);
+#  endif
+#endif
+
+/* Functions contained in mm_heapprof.c *************************************/
+
+#ifdef CONFIG_MM_HEAPPROF
+void mm_heapprof_malloc(FAR void *mem, size_t size);
+void mm_heapprof_free(FAR void *mem);
+void mm_heapprof_move(FAR void *oldmem, FAR void *newmem, size_t size);
+#endif
+
+/* Functions contained in mm_pressure.c *************************************/
+
+#ifdef MM_PRESSURE
+void mm_pressure_update(FAR struct mm_heap_s *heap);
+void mm_pressure_uninitialize(FAR struct mm_heap_s *heap);
+#endif
 
 #endif /* __MM_MM_HEAP_MM_H */
@@ -47,7 +47,6 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node)
 {
   FAR struct mm_freenode_s *next;
-  FAR struct mm_freenode_s *prev;
   size_t nodesize = MM_SIZEOF_NODE(node);
   int ndx;
 
@@ -58,23 +57,66 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
   ndx = mm_size2ndx(nodesize);
 
-  /* Now put the new node into the next */
+  /* Now put the new node at the head of its list */
 
-  for (prev = &heap->mm_nodelist[ndx],
-       next = heap->mm_nodelist[ndx].flink;
-       next && next->size && MM_SIZEOF_NODE(next) < nodesize;
-       prev = next, next = next->flink);
-
-  /* Does it go in mid next or at the end? */
-
-  prev->flink = node;
-  node->blink = prev;
+  next = heap->mm_nodelist[ndx];
+  node->blink = NULL;
   node->flink = next;
 
   if (next)
     {
-      /* The new node goes between prev and next */
-
       next->blink = node;
     }
+
+  heap->mm_nodelist[ndx] = node;
+
+  /* And mark the size class as not empty */
+
+  heap->mm_slmap[ndx >> MM_SL_SHIFT] |= 1u << (ndx & (MM_NSL - 1));
+  heap->mm_flmap |= 1u << (ndx >> MM_SL_SHIFT);
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the nodes list.  It is assumed that the caller
+ *   holds the mm mutex.
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  DEBUGASSERT(MM_NODE_IS_FREE(node));
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink)
+    {
+      DEBUGASSERT(node->blink->flink == node);
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      int ndx = mm_size2ndx(MM_SIZEOF_NODE(node));
+
+      /* The node is the head of its list, which may become empty */
+
+      DEBUGASSERT(heap->mm_nodelist[ndx] == node);
+      heap->mm_nodelist[ndx] = node->flink;
+      if (node->flink == NULL)
+        {
+          int fl = ndx >> MM_SL_SHIFT;
+
+          heap->mm_slmap[fl] &= ~(1u << (ndx & (MM_NSL - 1)));
+          if (heap->mm_slmap[fl] == 0)
+            {
+              heap->mm_flmap &= ~(1u << fl);
+            }
+        }
+    }
 }
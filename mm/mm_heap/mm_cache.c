@@ -0,0 +1,463 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <malloc.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+#include "kasan/kasan.h"
+
+#ifdef MM_HEAP_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of chunks moved between a bin and the heap at once */
+
+#if CONFIG_MM_HEAP_CACHE_DEPTH > 1
+#  define MM_CACHE_BATCH (CONFIG_MM_HEAP_CACHE_DEPTH / 2)
+#else
+#  define MM_CACHE_BATCH 1
+#endif
+
+/* Bin of a chunk size (including the allocation node) */
+
+#define MM_CACHE_NDX(size) ((size) / MM_ALIGN - 1)
+
+/* The allocation node in front of user memory */
+
+#define MM_CACHE_NODE(mem) \
+  ((FAR struct mm_allocnode_s *)((FAR char *)(mem) - MM_SIZEOF_ALLOCNODE))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_takeall
+ *
+ * Description:
+ *   Empty all bins of a cache.
+ *
+ * Returned Value:
+ *   The list of the chunks that were cached.
+ *
+ * Assumptions:
+ *   Called with the cache locked.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_delaynode_s *
+mm_cache_takeall(FAR struct mm_cache_s *cache,
+                 FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *node;
+  int i;
+
+  for (i = 0; i < MM_CACHE_NBINS; i++)
+    {
+      FAR struct mm_cachebin_s *bin = &cache->bins[i];
+
+      while ((node = bin->head) != NULL)
+        {
+          bin->head   = node->flink;
+          node->flink = list;
+          list        = node;
+        }
+
+      bin->count = 0;
+    }
+
+  cache->nbytes = 0;
+  return list;
+}
+
+/****************************************************************************
+ * Name: mm_cache_release
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap, taking the heap lock only
+ *   once for the whole list.
+ *
+ ****************************************************************************/
+
+static void mm_cache_release(FAR struct mm_heap_s *heap,
+                             FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *next;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* The heap can't be locked now, leave it to the delay list */
+
+      for (; list != NULL; list = next)
+        {
+          next = list->flink;
+          mm_delayfree(heap, list, false);
+        }
+
+      return;
+    }
+
+  for (; list != NULL; list = next)
+    {
+      next = list->flink;
+      mm_freechunk(heap, list);
+    }
+
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_cache_shrink
+ *
+ * Description:
+ *   The shrinker of a heap, see mm_register_shrinker().
+ *
+ ****************************************************************************/
+
+#ifdef MM_PRESSURE
+static size_t mm_cache_shrink(FAR void *arg, int level)
+{
+  return mm_cache_flush(arg);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Take a chunk of 'alignsize' bytes from the cache of this CPU.  An empty
+ *   bin is refilled with a batch of chunks under a single heap lock.
+ *
+ * Returned Value:
+ *   The user memory of the chunk, or NULL if the size is not cached or
+ *   the heap is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_delaynode_s *list = NULL;
+  FAR struct mm_delaynode_s *ret;
+  FAR struct mm_cachebin_s *bin;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int i;
+
+  if (alignsize > CONFIG_MM_HEAP_CACHE_MAXSIZE)
+    {
+      return NULL;
+    }
+
+  /* The lock is only contended by a flush, so it does not matter if we
+   * move to another CPU before it is taken.
+   */
+
+  cache = &heap->mm_cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  bin = &cache->bins[MM_CACHE_NDX(alignsize)];
+  ret = bin->head;
+  if (ret != NULL)
+    {
+      bin->head = ret->flink;
+      bin->count--;
+      cache->nbytes -= MM_SIZEOF_NODE(MM_CACHE_NODE(ret));
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (ret != NULL)
+    {
+      return ret;
+    }
+
+  /* The bin is empty, refill it */
+
+  if (mm_lock(heap) < 0)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < MM_CACHE_BATCH + 1; i++)
+    {
+      FAR struct mm_delaynode_s *node = mm_allocchunk(heap, alignsize);
+
+      if (node == NULL)
+        {
+          break;
+        }
+      else if (ret == NULL)
+        {
+          ret = node;
+        }
+      else
+        {
+          node->flink = list;
+          list        = node;
+        }
+    }
+
+  mm_unlock(heap);
+
+  if (list != NULL)
+    {
+      FAR struct mm_delaynode_s *next;
+
+      cache = &heap->mm_cache[up_cpu_index()];
+      flags = spin_lock_irqsave(&cache->lock);
+
+      bin = &cache->bins[MM_CACHE_NDX(alignsize)];
+
+      for (; list != NULL; list = next)
+        {
+          FAR struct mm_allocnode_s *node = MM_CACHE_NODE(list);
+
+#if CONFIG_MM_BACKTRACE >= 0
+          node->pid = PID_MM_MEMPOOL;
+#endif
+          kasan_poison(list, MM_SIZEOF_NODE(node) - MM_ALLOCNODE_OVERHEAD);
+
+          next        = list->flink;
+          list->flink = bin->head;
+          bin->head   = list;
+          bin->count++;
+          cache->nbytes += MM_SIZEOF_NODE(node);
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Put a small chunk into the cache of this CPU.  A bin holding more than
+ *   CONFIG_MM_HEAP_CACHE_DEPTH chunks returns a batch of them to the heap
+ *   under a single heap lock.
+ *
+ * Returned Value:
+ *   true if the chunk was cached, false if it must be freed to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node = MM_CACHE_NODE(mem);
+  FAR struct mm_delaynode_s *list = NULL;
+  FAR struct mm_delaynode_s *chunk = mem;
+  FAR struct mm_cachebin_s *bin;
+  FAR struct mm_cache_s *cache;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  irqstate_t flags;
+
+  if (nodesize > CONFIG_MM_HEAP_CACHE_MAXSIZE)
+    {
+      return false;
+    }
+
+  /* Sanity check against double-frees of uncached chunks */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, 0x55, nodesize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  kasan_poison(mem, nodesize - MM_ALLOCNODE_OVERHEAD);
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* Cached chunks are not leaked by their last owner */
+
+  node->pid = PID_MM_MEMPOOL;
+#endif
+
+  cache = &heap->mm_cache[up_cpu_index()];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  bin = &cache->bins[MM_CACHE_NDX(nodesize)];
+
+  chunk->flink   = bin->head;
+  bin->head      = chunk;
+  cache->nbytes += nodesize;
+
+  if (++bin->count > CONFIG_MM_HEAP_CACHE_DEPTH)
+    {
+      int i;
+
+      for (i = 0; i < MM_CACHE_BATCH; i++)
+        {
+          chunk          = bin->head;
+          bin->head      = chunk->flink;
+          chunk->flink   = list;
+          list           = chunk;
+          cache->nbytes -= MM_SIZEOF_NODE(MM_CACHE_NODE(chunk));
+        }
+
+      bin->count -= MM_CACHE_BATCH;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (list != NULL)
+    {
+      mm_cache_release(heap, list);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Let the shrinkers return the chunks cached for a new heap, so that an
+ *   allocation failing on another heap can still get them back.
+ *
+ ****************************************************************************/
+
+#ifdef MM_PRESSURE
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+  heap->mm_shrinker.shrink = mm_cache_shrink;
+  heap->mm_shrinker.arg    = heap;
+  mm_register_shrinker(&heap->mm_shrinker);
+}
+
+/****************************************************************************
+ * Name: mm_cache_uninitialize
+ *
+ * Description:
+ *   Undo mm_cache_initialize() for a heap that goes away.
+ *
+ ****************************************************************************/
+
+void mm_cache_uninitialize(FAR struct mm_heap_s *heap)
+{
+  mm_unregister_shrinker(&heap->mm_shrinker);
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return the chunks cached by all CPUs to the heap.  This is used when
+ *   the heap runs short of memory.
+ *
+ * Returned Value:
+ *   The number of bytes returned to the heap.
+ *
+ ****************************************************************************/
+
+size_t mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_delaynode_s *list = NULL;
+  irqstate_t flags;
+  size_t nbytes = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct mm_cache_s *cache = &heap->mm_cache[i];
+
+      flags   = spin_lock_irqsave(&cache->lock);
+      nbytes += cache->nbytes;
+      list    = mm_cache_takeall(cache, list);
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  if (list != NULL)
+    {
+      mm_cache_release(heap, list);
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: mm_cache_mallinfo
+ *
+ * Description:
+ *   Get the number (ordblks), the total size (fordblks) and the largest
+ *   size (mxordblk) of the chunks held by the caches of all CPUs.  The
+ *   result is a snapshot that may be stale by the time it is used.
+ *
+ ****************************************************************************/
+
+struct mallinfo mm_cache_mallinfo(FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info;
+  int i;
+  int j;
+
+  memset(&info, 0, sizeof(info));
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct mm_cache_s *cache = &heap->mm_cache[i];
+      irqstate_t flags;
+
+      flags = spin_lock_irqsave(&cache->lock);
+      for (j = 0; j < MM_CACHE_NBINS; j++)
+        {
+          size_t count = cache->bins[j].count;
+          size_t size = (j + 1) * MM_ALIGN;
+
+          if (count > 0)
+            {
+              info.ordblks  += count;
+              info.fordblks += count * size;
+              if (size > (size_t)info.mxordblk)
+                {
+                  info.mxordblk = size;
+                }
+            }
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return info;
+}
+
+#endif /* MM_HEAP_CACHE */
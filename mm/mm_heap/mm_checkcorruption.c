@@ -51,13 +51,14 @@ static void checkcorruption_handler(FAR struct mm_allocnode_s *node,
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       assert(nodesize >= MM_MIN_CHUNK);
-      assert(fnode->blink->flink == fnode);
-      assert(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
+      assert(fnode->blink == NULL ||
+             (fnode->blink->flink == fnode &&
+              mm_size2ndx(MM_SIZEOF_NODE(fnode->blink)) ==
+              mm_size2ndx(nodesize)));
       assert(fnode->flink == NULL ||
-             fnode->flink->blink == fnode);
-      assert(fnode->flink == NULL ||
-             MM_SIZEOF_NODE(fnode->flink) == 0 ||
-             MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+             (fnode->flink->blink == fnode &&
+              mm_size2ndx(MM_SIZEOF_NODE(fnode->flink)) ==
+              mm_size2ndx(nodesize)));
     }
 }
 
@@ -30,6 +30,7 @@
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
+#include "kasan/kasan.h"
 
 /****************************************************************************
  * Public Functions
@@ -56,6 +57,11 @@ bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
 {
 #if CONFIG_MM_REGIONS > 1
   int i;
+#endif
+
+  mem = kasan_reset_tag(mem);
+
+#if CONFIG_MM_REGIONS > 1
 
   /* A valid address from the heap for this region would have to lie
    * between the region's two guard nodes.
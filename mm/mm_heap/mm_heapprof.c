@@ -0,0 +1,783 @@
+/****************************************************************************
+ * mm/mm_heap/mm_heapprof.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/procfs.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPPROF_LINELEN      (64 + CONFIG_MM_HEAPPROF_DEPTH * 19)
+
+/* ln(2) in 16.16 fixed point */
+
+#define HEAPPROF_LN2          45426
+
+/* Number of random bits used to draw a sampling interval */
+
+#define HEAPPROF_RANDBITS     26
+
+#define HEAPPROF_PTRHASH(mem) ((uint32_t)((uintptr_t)(mem) >> 3) * 2654435761u)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Statistics of the sampled allocations of one call site */
+
+struct heapprof_site_s
+{
+  FAR void *backtrace[CONFIG_MM_HEAPPROF_DEPTH];
+  uint32_t  hash;        /* Hash of the backtrace, 0 if the slot is unused */
+  size_t    inuse_count; /* Sampled allocations still alive */
+  size_t    inuse_bytes; /* Bytes of those allocations */
+  size_t    peak_bytes;  /* Highest inuse_bytes seen */
+  size_t    alloc_count; /* Sampled allocations since the last reset */
+  size_t    alloc_bytes; /* Bytes of those allocations */
+};
+
+/* A sampled allocation that is still alive */
+
+struct heapprof_sample_s
+{
+  FAR void *mem;         /* The allocation, NULL if the slot is unused */
+  size_t    size;        /* The requested size */
+  uint16_t  site;        /* Index of the call site */
+};
+
+struct heapprof_s
+{
+  spinlock_t lock;
+  size_t     rate;       /* Mean bytes between samples, 0 when stopped */
+  uint32_t   armed;      /* CPUs with a valid countdown */
+  uint32_t   seed;       /* State of the interval generator */
+  size_t     nlive;      /* Number of live samples */
+  size_t     dropped;    /* Samples lost to full tables */
+  clock_t    start;      /* Time of the last reset */
+  ssize_t    countdown[CONFIG_SMP_NCPUS];
+  struct heapprof_site_s   sites[CONFIG_MM_HEAPPROF_NSITES];
+  struct heapprof_sample_s samples[CONFIG_MM_HEAPPROF_NSAMPLES];
+};
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[HEAPPROF_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t heapprof_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_heapprof_operations =
+{
+  heapprof_open,   /* open */
+  heapprof_close,  /* close */
+  heapprof_read,   /* read */
+  heapprof_write,  /* write */
+  NULL,            /* poll */
+  heapprof_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  heapprof_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct heapprof_s g_heapprof =
+{
+  SP_UNLOCKED,
+  CONFIG_MM_HEAPPROF_RATE,
+  0,
+  1
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_log2
+ *
+ * Description:
+ *   Return log2(x) in 16.16 fixed point, x must not be zero.
+ *
+ ****************************************************************************/
+
+static uint32_t heapprof_log2(uint32_t x)
+{
+  int n = fls(x) - 1;
+  uint64_t m = ((uint64_t)x << 16) >> n;
+  uint32_t ret = (uint32_t)n << 16;
+  int i;
+
+  /* m is in [1, 2) now, square it to get each fractional bit */
+
+  for (i = 15; i >= 0; i--)
+    {
+      m = (m * m) >> 16;
+      if (m >= (2 << 16))
+        {
+          m >>= 1;
+          ret |= 1 << i;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: heapprof_interval
+ *
+ * Description:
+ *   Draw the number of bytes until the next sample from an exponential
+ *   distribution with a mean of the sampling rate, so that every allocated
+ *   byte has the same chance of being sampled.
+ *
+ * Assumptions:
+ *   Called with the profiler locked.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_interval(void)
+{
+  uint32_t x = g_heapprof.seed;
+  uint64_t ln;
+
+  /* xorshift32 */
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  g_heapprof.seed = x;
+
+  /* -ln(u) for u uniform in (0, 1] */
+
+  x  = (x >> (32 - HEAPPROF_RANDBITS)) + 1;
+  ln = (HEAPPROF_RANDBITS << 16) - heapprof_log2(x);
+  ln = (ln * HEAPPROF_LN2) >> 16;
+
+  return (ssize_t)((ln * g_heapprof.rate) >> 16) + 1;
+}
+
+/****************************************************************************
+ * Name: heapprof_findsite
+ *
+ * Description:
+ *   Find or add the call site with a backtrace.  Returns its index or -1 if
+ *   the table is full.
+ *
+ * Assumptions:
+ *   Called with the profiler locked.
+ *
+ ****************************************************************************/
+
+static int heapprof_findsite(FAR void **backtrace)
+{
+  uint32_t hash = 2166136261u;
+  int ndx;
+  int i;
+
+  for (i = 0; i < CONFIG_MM_HEAPPROF_DEPTH; i++)
+    {
+      hash = (hash ^ (uint32_t)(uintptr_t)backtrace[i]) * 16777619u;
+    }
+
+  hash |= 1;
+  ndx   = hash % CONFIG_MM_HEAPPROF_NSITES;
+
+  for (i = 0; i < CONFIG_MM_HEAPPROF_NSITES; i++)
+    {
+      FAR struct heapprof_site_s *site = &g_heapprof.sites[ndx];
+
+      if (site->hash == 0)
+        {
+          memcpy(site->backtrace, backtrace, sizeof(site->backtrace));
+          site->hash = hash;
+          return ndx;
+        }
+      else if (site->hash == hash &&
+               memcmp(site->backtrace, backtrace,
+                      sizeof(site->backtrace)) == 0)
+        {
+          return ndx;
+        }
+
+      if (++ndx == CONFIG_MM_HEAPPROF_NSITES)
+        {
+          ndx = 0;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: heapprof_findsample
+ *
+ * Description:
+ *   Return the index of the live sample of an allocation, or of the free
+ *   slot where it would be added.  Returns -1 if it is not found and the
+ *   table is full.
+ *
+ * Assumptions:
+ *   Called with the profiler locked.
+ *
+ ****************************************************************************/
+
+static int heapprof_findsample(FAR void *mem)
+{
+  int ndx = HEAPPROF_PTRHASH(mem) % CONFIG_MM_HEAPPROF_NSAMPLES;
+  int i;
+
+  for (i = 0; i < CONFIG_MM_HEAPPROF_NSAMPLES; i++)
+    {
+      FAR void *cur = g_heapprof.samples[ndx].mem;
+
+      if (cur == mem || cur == NULL)
+        {
+          return ndx;
+        }
+
+      if (++ndx == CONFIG_MM_HEAPPROF_NSAMPLES)
+        {
+          ndx = 0;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: heapprof_delsample
+ *
+ * Description:
+ *   Remove a live sample, moving the samples after it back so that linear
+ *   probing still finds them.
+ *
+ * Assumptions:
+ *   Called with the profiler locked.
+ *
+ ****************************************************************************/
+
+static void heapprof_delsample(int ndx)
+{
+  int next = ndx;
+
+  for (; ; )
+    {
+      FAR struct heapprof_sample_s *sample;
+      int home;
+
+      if (++next == CONFIG_MM_HEAPPROF_NSAMPLES)
+        {
+          next = 0;
+        }
+
+      sample = &g_heapprof.samples[next];
+      if (sample->mem == NULL)
+        {
+          break;
+        }
+
+      /* Move the sample into the hole unless its home slot lies
+       * cyclically in (ndx, next].
+       */
+
+      home = HEAPPROF_PTRHASH(sample->mem) % CONFIG_MM_HEAPPROF_NSAMPLES;
+      if (ndx <= next ? (home <= ndx || home > next) :
+                        (home <= ndx && home > next))
+        {
+          g_heapprof.samples[ndx] = *sample;
+          ndx = next;
+        }
+    }
+
+  g_heapprof.samples[ndx].mem = NULL;
+  g_heapprof.nlive--;
+}
+
+/****************************************************************************
+ * Name: heapprof_record
+ *
+ * Description:
+ *   Account a sampled allocation to its call site.
+ *
+ * Assumptions:
+ *   Called with the profiler locked.
+ *
+ ****************************************************************************/
+
+static void heapprof_record(FAR void *mem, size_t size,
+                            FAR void **backtrace)
+{
+  FAR struct heapprof_site_s *site;
+  int ndx;
+  int sndx;
+
+  sndx = heapprof_findsite(backtrace);
+  ndx  = heapprof_findsample(mem);
+  if (sndx < 0 || ndx < 0 || g_heapprof.samples[ndx].mem != NULL)
+    {
+      g_heapprof.dropped++;
+      return;
+    }
+
+  g_heapprof.samples[ndx].mem  = mem;
+  g_heapprof.samples[ndx].size = size;
+  g_heapprof.samples[ndx].site = sndx;
+  g_heapprof.nlive++;
+
+  site = &g_heapprof.sites[sndx];
+  site->inuse_count++;
+  site->inuse_bytes += size;
+  site->alloc_count++;
+  site->alloc_bytes += size;
+  if (site->inuse_bytes > site->peak_bytes)
+    {
+      site->peak_bytes = site->inuse_bytes;
+    }
+}
+
+/****************************************************************************
+ * Name: heapprof_reset
+ *
+ * Description:
+ *   Drop all samples and restart the profiler with a new sampling rate.
+ *
+ ****************************************************************************/
+
+static void heapprof_reset(size_t rate)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  memset(g_heapprof.sites, 0, sizeof(g_heapprof.sites));
+  memset(g_heapprof.samples, 0, sizeof(g_heapprof.samples));
+  g_heapprof.nlive   = 0;
+  g_heapprof.dropped = 0;
+  g_heapprof.armed   = 0;
+  g_heapprof.rate    = rate;
+  g_heapprof.start   = clock_systime_ticks();
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Print the profile in the legacy text heap profile format of pprof.
+ *   Lines starting with '#' carry the data pprof does not know about and
+ *   are read by tools/heapprof.py.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *procfile = filep->f_priv;
+  struct heapprof_site_s total;
+  struct heapprof_site_s site;
+  irqstate_t flags;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  size_t dropped;
+  size_t rate;
+  clock_t elapsed;
+  off_t offset = filep->f_pos;
+  int i;
+  int j;
+
+  memset(&total, 0, sizeof(total));
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  for (i = 0; i < CONFIG_MM_HEAPPROF_NSITES; i++)
+    {
+      total.inuse_count += g_heapprof.sites[i].inuse_count;
+      total.inuse_bytes += g_heapprof.sites[i].inuse_bytes;
+      total.alloc_count += g_heapprof.sites[i].alloc_count;
+      total.alloc_bytes += g_heapprof.sites[i].alloc_bytes;
+    }
+
+  rate    = g_heapprof.rate;
+  dropped = g_heapprof.dropped;
+  elapsed = clock_systime_ticks() - g_heapprof.start;
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+
+  linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                              "heap profile: %zu: %zu [%zu: %zu] "
+                              "@ heap_v2/%zu\n"
+                              "# elapsed_ms %lu dropped %zu\n",
+                              total.inuse_count, total.inuse_bytes,
+                              total.alloc_count, total.alloc_bytes, rate,
+                              (unsigned long)TICK2MSEC(elapsed), dropped);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < CONFIG_MM_HEAPPROF_NSITES && totalsize < buflen; i++)
+    {
+      flags = spin_lock_irqsave(&g_heapprof.lock);
+      site  = g_heapprof.sites[i];
+      spin_unlock_irqrestore(&g_heapprof.lock, flags);
+
+      if (site.hash == 0 || site.alloc_count == 0)
+        {
+          continue;
+        }
+
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                                  "# peak %zu\n%zu: %zu [%zu: %zu] @",
+                                  site.peak_bytes, site.inuse_count,
+                                  site.inuse_bytes, site.alloc_count,
+                                  site.alloc_bytes);
+
+      for (j = 0; j < CONFIG_MM_HEAPPROF_DEPTH && site.backtrace[j]; j++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      HEAPPROF_LINELEN - linesize,
+                                      " %p", site.backtrace[j]);
+        }
+
+      /* pprof wants at least one address per sample */
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  HEAPPROF_LINELEN - linesize,
+                                  j == 0 ? " 0x0\n" : "\n");
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_write
+ *
+ * Description:
+ *   Writing a number restarts the profiler with that sampling rate in
+ *   bytes, 0 stops it.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  char str[16];
+  FAR char *end;
+  unsigned long rate;
+
+  if (buflen == 0 || buflen >= sizeof(str))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(str, buffer, buflen);
+  str[buflen] = '\0';
+
+  rate = strtoul(str, &end, 0);
+  if (end == str || (*end != '\0' && *end != '\n'))
+    {
+      return -EINVAL;
+    }
+
+  heapprof_reset(rate);
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct heapprof_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct heapprof_file_s));
+  newp->f_priv = newattr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapprof_malloc
+ *
+ * Description:
+ *   Account 'size' allocated bytes to the countdown of this CPU and sample
+ *   the allocation when the countdown expires.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_malloc(FAR void *mem, size_t size)
+{
+  FAR void *backtrace[CONFIG_MM_HEAPPROF_DEPTH];
+  irqstate_t flags;
+  int cpu;
+  int n;
+
+  if (g_heapprof.rate == 0)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  cpu   = up_cpu_index();
+  if ((g_heapprof.countdown[cpu] -= size) > 0 &&
+      (g_heapprof.armed & (1 << cpu)) != 0)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  up_irq_restore(flags);
+
+  n = sched_backtrace(_SCHED_GETTID(), backtrace, CONFIG_MM_HEAPPROF_DEPTH,
+                      CONFIG_MM_HEAPPROF_SKIP);
+  if (n < 0)
+    {
+      n = 0;
+    }
+
+  memset(&backtrace[n], 0,
+         (CONFIG_MM_HEAPPROF_DEPTH - n) * sizeof(FAR void *));
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  cpu   = up_cpu_index();
+
+  if (g_heapprof.rate != 0)
+    {
+      /* The first allocation after a reset only draws an interval */
+
+      if ((g_heapprof.armed & (1 << cpu)) != 0)
+        {
+          heapprof_record(mem, size, backtrace);
+        }
+
+      g_heapprof.armed |= 1 << cpu;
+      g_heapprof.countdown[cpu] = heapprof_interval();
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_free
+ *
+ * Description:
+ *   Drop the sample of an allocation that is freed, if it was sampled.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_free(FAR void *mem)
+{
+  irqstate_t flags;
+  int ndx;
+
+  /* Most frees find no live sample at all */
+
+  if (g_heapprof.nlive == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+
+  ndx = heapprof_findsample(mem);
+  if (ndx >= 0 && g_heapprof.samples[ndx].mem == mem)
+    {
+      FAR struct heapprof_sample_s *sample = &g_heapprof.samples[ndx];
+      FAR struct heapprof_site_s *site = &g_heapprof.sites[sample->site];
+
+      site->inuse_count--;
+      site->inuse_bytes -= sample->size;
+      heapprof_delsample(ndx);
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_move
+ *
+ * Description:
+ *   Move the sample of an allocation, if it was sampled, to the new address
+ *   and size of the same allocation.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_move(FAR void *oldmem, FAR void *newmem, size_t size)
+{
+  FAR struct heapprof_site_s *site;
+  irqstate_t flags;
+  size_t oldsize;
+  uint16_t sndx;
+  int ndx;
+
+  if (g_heapprof.nlive == 0 || oldmem == newmem)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+
+  ndx = heapprof_findsample(oldmem);
+  if (ndx >= 0 && g_heapprof.samples[ndx].mem == oldmem)
+    {
+      sndx    = g_heapprof.samples[ndx].site;
+      oldsize = g_heapprof.samples[ndx].size;
+      heapprof_delsample(ndx);
+
+      site = &g_heapprof.sites[sndx];
+      site->inuse_bytes += size - oldsize;
+      site->alloc_bytes += size - oldsize;
+
+      ndx = heapprof_findsample(newmem);
+      if (ndx >= 0 && g_heapprof.samples[ndx].mem == NULL)
+        {
+          g_heapprof.samples[ndx].mem  = newmem;
+          g_heapprof.samples[ndx].size = size;
+          g_heapprof.samples[ndx].site = sndx;
+          g_heapprof.nlive++;
+        }
+      else
+        {
+          site->inuse_count--;
+          site->inuse_bytes -= size;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
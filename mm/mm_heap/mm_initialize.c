@@ -219,10 +219,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 {
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   size_t poolsize[MEMPOOL_NPOOLS];
+  int                   i;
 #endif
   FAR struct mm_heap_s *heap;
   uintptr_t             heap_adj;
-  int                   i;
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
 
@@ -244,14 +244,6 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   memset(heap, 0, sizeof(struct mm_heap_s));
 
-  /* Initialize the node array */
-
-  for (i = 1; i < MM_NNODES; i++)
-    {
-      heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
-      heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
-    }
-
   /* Initialize the malloc mutex to one (to support one-at-
    * a-time access to private data sets).
    */
@@ -278,6 +270,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 #  endif
 #endif
 
+#if defined(MM_HEAP_CACHE) && defined(MM_PRESSURE)
+  mm_cache_initialize(heap);
+#endif
+
   /* Initialize the multiple mempool in heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
@@ -314,6 +310,13 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
 void mm_uninitialize(FAR struct mm_heap_s *heap)
 {
+#ifdef MM_PRESSURE
+#  ifdef MM_HEAP_CACHE
+  mm_cache_uninitialize(heap);
+#  endif
+  mm_pressure_uninitialize(heap);
+#endif
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
@@ -325,3 +328,34 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 #endif
   nxmutex_destroy(&heap->mm_lock);
 }
+
+/****************************************************************************
+ * Name: mm_kasan_enable
+ *
+ * Description:
+ *   Enable or disable the KASan checks of all regions of a heap.
+ *
+ * Input Parameters:
+ *   heap   - The heap to check
+ *   enable - true to check the accesses to the heap
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable)
+{
+#if CONFIG_MM_REGIONS > 1
+  int i;
+
+  for (i = 0; i < heap->mm_nregions; i++)
+    {
+      kasan_enable(heap->mm_heapstart[i], enable);
+    }
+#else
+  kasan_enable(heap->mm_heapstart[0], enable);
+#endif
+}
+#endif
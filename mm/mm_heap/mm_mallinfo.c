@@ -67,13 +67,14 @@ static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
-      DEBUGASSERT(fnode->blink->flink == fnode);
-      DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
+      DEBUGASSERT(fnode->blink == NULL ||
+                  (fnode->blink->flink == fnode &&
+                   mm_size2ndx(MM_SIZEOF_NODE(fnode->blink)) ==
+                   mm_size2ndx(nodesize)));
       DEBUGASSERT(fnode->flink == NULL ||
-                  fnode->flink->blink == fnode);
-      DEBUGASSERT(fnode->flink == NULL ||
-                  MM_SIZEOF_NODE(fnode->flink) == 0 ||
-                  MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+                  (fnode->flink->blink == fnode &&
+                   mm_size2ndx(MM_SIZEOF_NODE(fnode->flink)) ==
+                   mm_size2ndx(nodesize)));
 
       info->ordblks++;
       info->fordblks += nodesize;
@@ -139,6 +140,9 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   struct mallinfo poolinfo;
 #endif
+#ifdef MM_HEAP_CACHE
+  struct mallinfo cacheinfo;
+#endif
 
   memset(&info, 0, sizeof(info));
   mm_foreach(heap, mallinfo_handler, &info);
@@ -154,6 +158,22 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.fordblks += poolinfo.fordblks;
 #endif
 
+#ifdef MM_HEAP_CACHE
+  /* Chunks cached by the CPUs are allocated in the heap, but they are free
+   * for the user.
+   */
+
+  cacheinfo = mm_cache_mallinfo(heap);
+  info.aordblks -= cacheinfo.ordblks;
+  info.ordblks  += cacheinfo.ordblks;
+  info.uordblks -= cacheinfo.fordblks;
+  info.fordblks += cacheinfo.fordblks;
+  if (cacheinfo.mxordblk > info.mxordblk)
+    {
+      info.mxordblk = cacheinfo.mxordblk;
+    }
+#endif
+
   DEBUGASSERT(info.uordblks + info.fordblks == info.arena);
 
   return info;
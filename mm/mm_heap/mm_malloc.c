@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <string.h>
+#include <strings.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/mm/mm.h>
@@ -39,6 +40,60 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_findfreelist
+ *
+ * Description:
+ *  Find the first non-empty nodelist whose chunks are all at least
+ *  'alignsize' bytes.  The request is rounded up to the next size class
+ *  boundary so that the head of the list found can be taken as is.
+ *
+ * Returned Value:
+ *  The nodelist index, or -1 if there is no such list.
+ *
+ ****************************************************************************/
+
+static int mm_findfreelist(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  uint32_t map;
+  int ndx;
+  int fl;
+
+  if (alignsize >= MM_MAX_CHUNK)
+    {
+      /* The chunks in the last list have no upper bound */
+
+      return -1;
+    }
+
+  alignsize += ((size_t)1 << (flsl(alignsize) - 1 - MM_SL_SHIFT)) - 1;
+  ndx = mm_size2ndx(alignsize);
+
+  /* Search the rest of this power-of-two range first, then the next
+   * non-empty range.
+   */
+
+  fl  = ndx >> MM_SL_SHIFT;
+  map = heap->mm_slmap[fl] & (UINT32_MAX << (ndx & (MM_NSL - 1)));
+  if (map == 0)
+    {
+      map = heap->mm_flmap & (UINT32_MAX << (fl + 1));
+      if (map == 0)
+        {
+          return -1;
+        }
+
+      fl  = ffs(map) - 1;
+      map = heap->mm_slmap[fl];
+    }
+
+  /* This may be the last list, whose chunks are larger than any request
+   * that gets here.
+   */
+
+  return (fl << MM_SL_SHIFT) + ffs(map) - 1;
+}
+
 /****************************************************************************
  * Name: free_delaylist
  *
@@ -138,100 +193,62 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *  Take a chunk of 'alignsize' bytes (including the allocation node) from
+ *  the list of free nodes, splitting off the remainder.  The caller must
+ *  hold the heap lock.
  *
- *  8-byte alignment of the allocated data is assured.
+ * Returned Value:
+ *  The user memory of the chunk, or NULL if no chunk is large enough.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
   int ndx;
 
-  /* Free the delay list first */
-
-  free_delaylist(heap, false);
-
-#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
-  ret = mempool_multiple_alloc(heap->mm_mpool, size);
-  if (ret != NULL)
-    {
-      return ret;
-    }
-#endif
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
-   * least MM_MIN_CHUNK.
+  /* Look for the first non-empty size class whose chunks are all large
+   * enough, which is an O(1) operation.
    */
 
-  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+  ndx = mm_findfreelist(heap, alignsize);
+  if (ndx >= 0)
     {
-      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
+      node = heap->mm_nodelist[ndx];
     }
-
-  alignsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
-  if (alignsize < size)
+  else
     {
-      /* There must have been an integer overflow */
-
-      return NULL;
-    }
-
-  DEBUGASSERT(alignsize >= MM_ALIGN);
-
-  /* We need to hold the MM mutex while we muck with the nodelist. */
-
-  DEBUGVERIFY(mm_lock(heap));
-
-  /* Convert the request size into a nodelist index */
-
-  ndx = mm_size2ndx(alignsize);
-
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
+      /* Fall back to the chunks that may be large enough: those in the
+       * class of the request itself, or the last class that holds all
+       * chunks above MM_MAX_CHUNK.
+       */
 
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
-    {
-      DEBUGASSERT(node->blink->flink == node);
-      nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize >= alignsize)
+      ndx = mm_size2ndx(alignsize);
+      for (node = heap->mm_nodelist[ndx]; node; node = node->flink)
         {
-          break;
+          if (MM_SIZEOF_NODE(node) >= alignsize)
+            {
+              break;
+            }
         }
     }
 
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that it must be the best fitting chunk
-   * available.
-   */
-
   if (node)
     {
       FAR struct mm_freenode_s *remainder;
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from its list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      nodesize = MM_SIZEOF_NODE(node);
+      DEBUGASSERT(nodesize >= alignsize);
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -297,12 +314,79 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = (FAR void *)((FAR char *)node + MM_SIZEOF_ALLOCNODE);
     }
 
-  DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
-  mm_unlock(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  size_t alignsize;
+  FAR void *ret = NULL;
+
+  /* Free the delay list first */
+
+  free_delaylist(heap, false);
+
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  ret = mempool_multiple_alloc(heap->mm_mpool, size);
+  if (ret != NULL)
+    {
+      MM_HEAPPROF_MALLOC(heap, ret, size);
+      return ret;
+    }
+#endif
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
+   * least MM_MIN_CHUNK.
+   */
+
+  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+    {
+      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
+    }
+
+  alignsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
+  if (alignsize < size)
+    {
+      /* There must have been an integer overflow */
+
+      return NULL;
+    }
+
+  DEBUGASSERT(alignsize >= MM_ALIGN);
+
+#ifdef MM_HEAP_CACHE
+  /* Small chunks come from the cache of this CPU first */
+
+  ret = mm_cache_alloc(heap, alignsize);
+  if (ret == NULL)
+#endif
+    {
+      /* We need to hold the MM mutex while we muck with the nodelist. */
+
+      DEBUGVERIFY(mm_lock(heap));
+      ret = mm_allocchunk(heap, alignsize);
+      DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
+      mm_unlock(heap);
+      MM_PRESSURE_UPDATE(heap);
+    }
 
   if (ret)
     {
-      MM_ADD_BACKTRACE(heap, node);
+      MM_ADD_BACKTRACE(heap, (FAR char *)ret - MM_SIZEOF_ALLOCNODE);
+      MM_HEAPPROF_MALLOC(heap, ret, size);
+      ret = kasan_set_tag(ret);
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, 0xaa, alignsize - MM_ALLOCNODE_OVERHEAD);
@@ -321,6 +405,26 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#if defined(MM_HEAP_CACHE) && !defined(MM_PRESSURE)
+  /* Try again after returning the cached chunks to the heap.  With
+   * MM_PRESSURE the shrinker of the heap cache does this below.
+   */
+
+  else if (mm_cache_flush(heap))
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
+#ifdef MM_PRESSURE
+  /* Try again after the shrinkers returned cached memory */
+
+  else if (mm_shrink(MM_PRESSURE_CRITICAL) > 0)
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   else if (MM_INTERNAL_HEAP(heap))
     {
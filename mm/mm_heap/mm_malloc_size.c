@@ -30,6 +30,7 @@
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
+#include "kasan/kasan.h"
 
 /****************************************************************************
  * Public Functions
@@ -39,7 +40,13 @@ size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
-  ssize_t size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
+  ssize_t size;
+#endif
+
+  mem = kasan_reset_tag(mem);
+
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
 
   if (size >= 0)
     {
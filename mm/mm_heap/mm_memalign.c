@@ -76,6 +76,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
   if (node != NULL)
     {
+      MM_HEAPPROF_MALLOC(heap, node, size);
       return node;
     }
 #endif
@@ -126,7 +127,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (uintptr_t)mm_malloc(heap, allocsize);
+  rawchunk = (uintptr_t)kasan_reset_tag(mm_malloc(heap, allocsize));
   if (rawchunk == 0)
     {
       return NULL;
@@ -199,16 +200,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
           FAR struct mm_freenode_s *prev =
             (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
 
-          /* Remove the node.  There must be a predecessor, but there may
-           * not be a successor node.
-           */
+          /* Remove the previous node from its list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += MM_SIZEOF_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
@@ -268,9 +262,16 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
   mm_unlock(heap);
+  MM_PRESSURE_UPDATE(heap);
 
   MM_ADD_BACKTRACE(heap, node);
 
+  /* mm_malloc() profiled the raw chunk */
+
+  MM_HEAPPROF_MOVE(heap, (FAR void *)rawchunk, (FAR void *)alignedchunk,
+                   size);
+
+  alignedchunk = (uintptr_t)kasan_set_tag((FAR void *)alignedchunk);
   kasan_unpoison((FAR void *)alignedchunk,
                  mm_malloc_size(heap, (FAR void *)alignedchunk));
 
@@ -106,13 +106,14 @@ static void memdump_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
-      DEBUGASSERT(fnode->blink->flink == fnode);
-      DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
+      DEBUGASSERT(fnode->blink == NULL ||
+                  (fnode->blink->flink == fnode &&
+                   mm_size2ndx(MM_SIZEOF_NODE(fnode->blink)) ==
+                   mm_size2ndx(nodesize)));
       DEBUGASSERT(fnode->flink == NULL ||
-                  fnode->flink->blink == fnode);
-      DEBUGASSERT(fnode->flink == NULL ||
-                  MM_SIZEOF_NODE(fnode->flink) == 0 ||
-                  MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+                  (fnode->flink->blink == fnode &&
+                   mm_size2ndx(MM_SIZEOF_NODE(fnode->flink)) ==
+                   mm_size2ndx(nodesize)));
 
       syslog(LOG_INFO, "%12zu%*p\n",
              nodesize, MM_PTR_FMT_WIDTH,
@@ -0,0 +1,650 @@
+/****************************************************************************
+ * mm/mm_heap/mm_pressure.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <sched.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PRESSURE_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS
+/* This structure describes one open "file" */
+
+struct mempressure_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  FAR struct pollfd *fds;         /* The poll waiter of this file */
+  uint32_t seen;                  /* Events when the file was last read */
+  int threshold;                  /* Lowest level that wakes up poll() */
+  char line[PRESSURE_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS
+static int     mempressure_open(FAR struct file *filep,
+                                FAR const char *relpath, int oflags,
+                                mode_t mode);
+static int     mempressure_close(FAR struct file *filep);
+static ssize_t mempressure_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen);
+static ssize_t mempressure_write(FAR struct file *filep,
+                                 FAR const char *buffer, size_t buflen);
+static int     mempressure_poll(FAR struct file *filep,
+                                FAR struct pollfd *fds, bool setup);
+static int     mempressure_dup(FAR const struct file *oldp,
+                               FAR struct file *newp);
+static int     mempressure_stat(FAR const char *relpath,
+                                FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS
+const struct procfs_operations g_mempressure_operations =
+{
+  mempressure_open,   /* open */
+  mempressure_close,  /* close */
+  mempressure_read,   /* read */
+  mempressure_write,  /* write */
+  mempressure_poll,   /* poll */
+  mempressure_dup,    /* dup */
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+  mempressure_stat    /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_pressure_names[] =
+{
+  "none",
+  "low",
+  "critical"
+};
+
+/* The registered shrinkers, protected by a recursive mutex so that a
+ * shrinker that allocates memory doesn't call the shrinkers again.
+ */
+
+static FAR struct mm_shrinker_s *g_shrinkers;
+static rmutex_t g_shrinker_lock = NXRMUTEX_INITIALIZER;
+
+/* The number of heaps under low and critical pressure and the worst level
+ * of all heaps, protected by the critical section.
+ */
+
+static unsigned int g_pressure_nheaps[MM_PRESSURE_CRITICAL + 1];
+static int g_pressure_level;
+
+/* Statistics */
+
+static uint32_t g_pressure_events;   /* Rises of the pressure level */
+static size_t g_pressure_reclaimed;  /* Bytes returned by the shrinkers */
+
+#ifdef CONFIG_FS_PROCFS
+/* The open files that wait in poll() */
+
+static FAR struct mempressure_file_s *
+g_pressure_pollers[CONFIG_MM_PRESSURE_NPOLLWAITERS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pressure_account
+ *
+ * Description:
+ *   Move a heap to a new pressure level.  Called within the critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void mm_pressure_account(FAR struct mm_heap_s *heap, int level)
+{
+  if (heap->mm_pressure != MM_PRESSURE_NONE)
+    {
+      g_pressure_nheaps[heap->mm_pressure]--;
+    }
+
+  if (level != MM_PRESSURE_NONE)
+    {
+      g_pressure_nheaps[level]++;
+    }
+
+  heap->mm_pressure = level;
+}
+
+/****************************************************************************
+ * Name: mm_pressure_worst
+ *
+ * Description:
+ *   Return the worst pressure level of all heaps.  Called within the
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static int mm_pressure_worst(void)
+{
+  if (g_pressure_nheaps[MM_PRESSURE_CRITICAL] > 0)
+    {
+      return MM_PRESSURE_CRITICAL;
+    }
+  else if (g_pressure_nheaps[MM_PRESSURE_LOW] > 0)
+    {
+      return MM_PRESSURE_LOW;
+    }
+
+  return MM_PRESSURE_NONE;
+}
+
+/****************************************************************************
+ * Name: mempressure_ready
+ *
+ * Description:
+ *   Return true if the pressure level rose to the threshold of the file
+ *   since it was last read.  Called within the critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS
+static bool mempressure_ready(FAR struct mempressure_file_s *procfile)
+{
+  return g_pressure_level >= procfile->threshold &&
+         g_pressure_events != procfile->seen;
+}
+
+/****************************************************************************
+ * Name: mempressure_open
+ ****************************************************************************/
+
+static int mempressure_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, mode_t mode)
+{
+  FAR struct mempressure_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct mempressure_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  procfile->threshold = MM_PRESSURE_LOW;
+  filep->f_priv = procfile;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempressure_close
+ ****************************************************************************/
+
+static int mempressure_close(FAR struct file *filep)
+{
+  FAR struct mempressure_file_s *procfile = filep->f_priv;
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_MM_PRESSURE_NPOLLWAITERS; i++)
+    {
+      if (g_pressure_pollers[i] == procfile)
+        {
+          g_pressure_pollers[i] = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempressure_read
+ *
+ * Description:
+ *   Print the current pressure level, the number of times the level rose
+ *   and the bytes reclaimed by the shrinkers.  Reading the file also
+ *   consumes the pending events that poll() reports.
+ *
+ ****************************************************************************/
+
+static ssize_t mempressure_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct mempressure_file_s *procfile = filep->f_priv;
+  irqstate_t flags;
+  uint32_t events;
+  size_t reclaimed;
+  size_t linesize;
+  size_t copysize;
+  off_t offset = filep->f_pos;
+  int level;
+
+  flags     = enter_critical_section();
+  level     = g_pressure_level;
+  events    = g_pressure_events;
+  reclaimed = g_pressure_reclaimed;
+  procfile->seen = events;
+  leave_critical_section(flags);
+
+  linesize = procfs_snprintf(procfile->line, PRESSURE_LINELEN,
+                             "level %s\nevents %" PRIu32 "\n"
+                             "reclaimed %zu\n",
+                             g_pressure_names[level], events, reclaimed);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                           &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: mempressure_write
+ *
+ * Description:
+ *   Writing "low" or "critical" sets the lowest level that wakes up poll()
+ *   on this file.
+ *
+ ****************************************************************************/
+
+static ssize_t mempressure_write(FAR struct file *filep,
+                                 FAR const char *buffer, size_t buflen)
+{
+  FAR struct mempressure_file_s *procfile = filep->f_priv;
+  size_t len = buflen;
+  int level;
+
+  if (len > 0 && buffer[len - 1] == '\n')
+    {
+      len--;
+    }
+
+  for (level = MM_PRESSURE_LOW; level <= MM_PRESSURE_CRITICAL; level++)
+    {
+      if (len == strlen(g_pressure_names[level]) &&
+          strncmp(buffer, g_pressure_names[level], len) == 0)
+        {
+          procfile->threshold = level;
+          return buflen;
+        }
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: mempressure_poll
+ *
+ * Description:
+ *   The file becomes readable when the pressure level rises to the
+ *   threshold of the file.
+ *
+ ****************************************************************************/
+
+static int mempressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup)
+{
+  FAR struct mempressure_file_s *procfile = filep->f_priv;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_MM_PRESSURE_NPOLLWAITERS; i++)
+        {
+          if (g_pressure_pollers[i] == NULL)
+            {
+              g_pressure_pollers[i] = procfile;
+              procfile->fds = fds;
+              fds->priv     = &g_pressure_pollers[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_MM_PRESSURE_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else if (mempressure_ready(procfile))
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct mempressure_file_s **)fds->priv = NULL;
+      procfile->fds = NULL;
+      fds->priv     = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mempressure_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mempressure_dup(FAR const struct file *oldp,
+                           FAR struct file *newp)
+{
+  FAR struct mempressure_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct mempressure_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct mempressure_file_s));
+  newattr->fds = NULL;
+  newp->f_priv = newattr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempressure_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mempressure_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return 0;
+}
+#endif /* CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pressure_update
+ *
+ * Description:
+ *   Recompute the pressure level of a heap from its free memory and wake
+ *   up the pollers of /proc/mempressure when the worst level of all heaps
+ *   rises.  Called without the heap lock after the heap changed.
+ *
+ ****************************************************************************/
+
+void mm_pressure_update(FAR struct mm_heap_s *heap)
+{
+  irqstate_t flags;
+  size_t nfree;
+  size_t low;
+  size_t critical;
+  int level;
+#ifdef CONFIG_FS_PROCFS
+  int i;
+#endif
+
+  low      = heap->mm_watermark[0];
+  critical = heap->mm_watermark[1];
+
+  if (low == 0)
+    {
+      low = heap->mm_heapsize / 100 * CONFIG_MM_PRESSURE_LOW;
+    }
+
+  if (critical == 0)
+    {
+      critical = heap->mm_heapsize / 100 * CONFIG_MM_PRESSURE_CRITICAL;
+    }
+
+  nfree = heap->mm_heapsize - heap->mm_curused;
+  level = nfree <= critical ? MM_PRESSURE_CRITICAL :
+          nfree <= low ? MM_PRESSURE_LOW : MM_PRESSURE_NONE;
+
+  if (level == heap->mm_pressure)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  mm_pressure_account(heap, level);
+  level = mm_pressure_worst();
+
+  if (level > g_pressure_level)
+    {
+      g_pressure_level = level;
+      g_pressure_events++;
+
+#ifdef CONFIG_FS_PROCFS
+      for (i = 0; i < CONFIG_MM_PRESSURE_NPOLLWAITERS; i++)
+        {
+          FAR struct mempressure_file_s *procfile = g_pressure_pollers[i];
+
+          if (procfile != NULL && mempressure_ready(procfile))
+            {
+              poll_notify(&procfile->fds, 1, POLLIN);
+            }
+        }
+#endif
+    }
+  else
+    {
+      g_pressure_level = level;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: mm_pressure_uninitialize
+ *
+ * Description:
+ *   Stop accounting the pressure level of a heap that goes away.
+ *
+ ****************************************************************************/
+
+void mm_pressure_uninitialize(FAR struct mm_heap_s *heap)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  mm_pressure_account(heap, MM_PRESSURE_NONE);
+  g_pressure_level = mm_pressure_worst();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: mm_set_watermarks
+ *
+ * Description:
+ *   Set the free bytes below which a heap is under low or critical
+ *   pressure.  0 selects the default percentage of the heap size.
+ *
+ ****************************************************************************/
+
+void mm_set_watermarks(FAR struct mm_heap_s *heap, size_t low,
+                       size_t critical)
+{
+  DEBUGASSERT(low == 0 || critical <= low);
+
+  heap->mm_watermark[0] = low;
+  heap->mm_watermark[1] = critical;
+  mm_pressure_update(heap);
+}
+
+/****************************************************************************
+ * Name: mm_pressure
+ *
+ * Description:
+ *   Return the pressure level of a heap, MM_PRESSURE_NONE, MM_PRESSURE_LOW
+ *   or MM_PRESSURE_CRITICAL.
+ *
+ ****************************************************************************/
+
+int mm_pressure(FAR struct mm_heap_s *heap)
+{
+  return heap->mm_pressure;
+}
+
+/****************************************************************************
+ * Name: mm_register_shrinker
+ *
+ * Description:
+ *   Register a callback that returns cached memory to the heaps.  The
+ *   shrinker structure must stay valid until it is unregistered.
+ *
+ ****************************************************************************/
+
+void mm_register_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  DEBUGASSERT(shrinker != NULL && shrinker->shrink != NULL);
+
+  nxrmutex_lock(&g_shrinker_lock);
+  shrinker->flink = g_shrinkers;
+  g_shrinkers     = shrinker;
+  nxrmutex_unlock(&g_shrinker_lock);
+}
+
+/****************************************************************************
+ * Name: mm_unregister_shrinker
+ *
+ * Description:
+ *   Remove a shrinker registered with mm_register_shrinker().  Once this
+ *   returns, the shrinker is not running and will not be called again.
+ *
+ ****************************************************************************/
+
+void mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  FAR struct mm_shrinker_s **prev;
+
+  nxrmutex_lock(&g_shrinker_lock);
+  for (prev = &g_shrinkers; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == shrinker)
+        {
+          *prev = shrinker->flink;
+          break;
+        }
+    }
+
+  nxrmutex_unlock(&g_shrinker_lock);
+}
+
+/****************************************************************************
+ * Name: mm_shrink
+ *
+ * Description:
+ *   Ask all registered shrinkers to return cached memory.  The allocator
+ *   calls this with MM_PRESSURE_CRITICAL before an allocation fails.
+ *   Nothing is done where the shrinker lock cannot be taken: from
+ *   interrupt handlers, from the idle task, with the scheduler locked or
+ *   from within a shrinker.
+ *
+ * Returned Value:
+ *   The number of bytes reclaimed.
+ *
+ ****************************************************************************/
+
+size_t mm_shrink(int level)
+{
+  FAR struct mm_shrinker_s *shrinker;
+  irqstate_t flags;
+  size_t reclaimed = 0;
+
+  if (up_interrupt_context() || sched_idletask() ||
+      sched_lockcount() > 0 || nxrmutex_is_hold(&g_shrinker_lock))
+    {
+      return 0;
+    }
+
+  nxrmutex_lock(&g_shrinker_lock);
+  for (shrinker = g_shrinkers; shrinker != NULL; shrinker = shrinker->flink)
+    {
+      reclaimed += shrinker->shrink(shrinker->arg, level);
+    }
+
+  nxrmutex_unlock(&g_shrinker_lock);
+
+  if (reclaimed > 0)
+    {
+      flags = enter_critical_section();
+      g_pressure_reclaimed += reclaimed;
+      leave_critical_section(flags);
+    }
+
+  return reclaimed;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
@@ -81,12 +81,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       return mm_malloc(heap, size);
     }
 
+  /* The heap works with untagged pointers */
+
+  oldmem = kasan_reset_tag(oldmem);
+
   DEBUGASSERT(mm_heapmember(heap, oldmem));
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
   if (newmem != NULL)
     {
+      MM_HEAPPROF_REALLOC(heap, oldmem, newmem, size);
       return newmem;
     }
   else if (size <= CONFIG_MM_HEAP_MEMPOOL_THRESHOLD ||
@@ -148,12 +153,22 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                        sizeof(mmsize_t), oldsize - MM_SIZEOF_NODE(oldnode));
         }
 
-      /* Then return the original address */
+      /* Then return the original address, with a new tag that invalidates
+       * the old pointer
+       */
 
       mm_unlock(heap);
+      MM_PRESSURE_UPDATE(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      MM_HEAPPROF_REALLOC(heap, oldmem, oldmem, size);
+
+      newmem = kasan_set_tag(oldmem);
+      if (newmem != oldmem)
+        {
+          kasan_unpoison(newmem, mm_malloc_size(heap, newmem));
+        }
 
-      return oldmem;
+      return newmem;
     }
 
   /* This is a request to increase the size of the allocation,  Get the
@@ -244,16 +259,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from its list */
 
-          DEBUGASSERT(prev && prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Make sure the new previous node has enough space */
 
@@ -317,16 +325,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           andbeyond = (FAR struct mm_allocnode_s *)
                       ((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from its list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Make sure the new next node has enough space */
 
@@ -374,10 +375,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         }
 
       mm_unlock(heap);
+      MM_PRESSURE_UPDATE(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
+      MM_HEAPPROF_REALLOC(heap, oldmem, newmem, size);
 
+      newmem = kasan_set_tag(newmem);
       kasan_unpoison(newmem, mm_malloc_size(heap, newmem));
-      if (newmem != oldmem)
+      if (kasan_reset_tag(newmem) != oldmem)
         {
           /* Now we have to move the user contents 'down' in memory.  memcpy
            * should be safe for this.
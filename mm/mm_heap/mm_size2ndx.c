@@ -24,7 +24,8 @@
 
 #include <nuttx/config.h>
 
-#include <string.h>
+#include <assert.h>
+#include <strings.h>
 
 #include <nuttx/mm/mm.h>
 
@@ -38,18 +39,24 @@
  * Name: mm_size2ndx
  *
  * Description:
- *    Convert the size to a nodelist index.
+ *    Convert the size to a nodelist index.  The power-of-two range of the
+ *    size gives the first level index, the next MM_SL_SHIFT bits below the
+ *    most significant one give the second level index.  All sizes of
+ *    MM_MAX_CHUNK or more map to the last index.
  *
  ****************************************************************************/
 
 int mm_size2ndx(size_t size)
 {
+  int fl;
+
   DEBUGASSERT(size >= MM_MIN_CHUNK);
   if (size >= MM_MAX_CHUNK)
     {
       return MM_NNODES - 1;
     }
 
-  size >>= MM_MIN_SHIFT;
-  return flsl(size) - 1;
+  fl = flsl(size) - 1;
+  return ((fl - MM_MIN_SHIFT) << MM_SL_SHIFT) +
+         ((size >> (fl - MM_SL_SHIFT)) & (MM_NSL - 1));
 }
@@ -1381,6 +1381,37 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   tlsf_destroy(&heap->mm_tlsf);
 }
 
+/****************************************************************************
+ * Name: mm_kasan_enable
+ *
+ * Description:
+ *   Enable or disable the KASan checks of all regions of a heap.
+ *
+ * Input Parameters:
+ *   heap   - The heap to check
+ *   enable - true to check the accesses to the heap
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable)
+{
+#if CONFIG_MM_REGIONS > 1
+  int i;
+
+  for (i = 0; i < heap->mm_nregions; i++)
+    {
+      kasan_enable(heap->mm_heapstart[i], enable);
+    }
+#else
+  kasan_enable(heap->mm_heapstart[0], enable);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: mm_zalloc
  *
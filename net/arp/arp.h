@@ -37,12 +37,14 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <errno.h>
 
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -159,10 +161,16 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+  hash_node_t              at_hash;     /* Hash bucket, keyed by IP address */
+  dq_entry_t               at_lru;      /* Position in the LRU list */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
-  clock_t                  at_time;     /* Time of last usage */
+  clock_t                  at_time;     /* Time of last update */
+  bool                     at_used;     /* Found since last moved in LRU */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+#ifdef CONFIG_NET_ARP_SEND
+  uint8_t                  at_refresh;  /* State of background refresh */
+#endif
 };
 
 /****************************************************************************
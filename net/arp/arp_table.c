@@ -55,6 +55,8 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -71,6 +73,26 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* Entries used within this time of their expiration are refreshed */
+
+#if defined(CONFIG_NET_ARP_SEND) && CONFIG_NET_ARP_REFRESH_WINDOW > 0
+#  define ARP_REFRESH 1
+#  define ARP_REFRESH_TICK SEC2TICK(CONFIG_NET_ARP_REFRESH_WINDOW)
+#  if CONFIG_NET_ARP_REFRESH_WINDOW >= 10 * CONFIG_NET_ARP_MAXAGE
+#    error CONFIG_NET_ARP_REFRESH_WINDOW must be less than the entry lifetime
+#  endif
+#endif
+
+/* The key of an entry in the hashtable */
+
+#define ARP_HASH_KEY(ipaddr) NTOHL(ipaddr)
+
+/* Values of at_refresh */
+
+#define ARP_REFRESH_NONE    0 /* No refresh needed */
+#define ARP_REFRESH_PENDING 1 /* Waiting for the refresh work */
+#define ARP_REFRESH_SENT    2 /* The ARP request was sent */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -89,6 +111,23 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries in use, hashed by IP address */
+
+static DECLARE_HASHTABLE(g_arphash, CONFIG_NET_ARP_HASH_BITS);
+
+/* All entries, approximately ordered from the most to the least recently
+ * used.  Unused entries are kept at the tail.  A lookup only sets at_used,
+ * so that it can be done with the table locked for reading; an entry is
+ * moved to the head when it is updated, or when it reaches the tail with
+ * at_used set (see arp_replace()).
+ */
+
+static dq_queue_t g_arplru;
+
+#ifdef ARP_REFRESH
+static struct work_s g_arprefresh;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -140,32 +179,92 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_table_init
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Put all entries of the ARP table in the LRU list on first use.
+ *
+ * Assumptions:
+ *   The caller holds the table write lock.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_table_init(void)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
+  int i;
+
+  if (dq_peek(&g_arplru) == NULL)
     {
-      return e2;
+      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+        {
+          dq_addlast(&g_arptable[i].at_lru, &g_arplru);
+        }
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from the hashtable and move it to the tail of the LRU
+ *   list, where it is the first candidate for reuse.
+ *
+ * Assumptions:
+ *   The caller holds the table write lock.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  if (tabptr->at_ipaddr != 0)
     {
-      return e1;
+      hashtable_delete(g_arphash, &tabptr->at_hash,
+                       ARP_HASH_KEY(tabptr->at_ipaddr));
+      tabptr->at_ipaddr = 0;
     }
-  else
+
+#ifdef ARP_REFRESH
+  tabptr->at_refresh = ARP_REFRESH_NONE;
+#endif
+
+  tabptr->at_used = false;
+  dq_rem(&tabptr->at_lru, &g_arplru);
+  dq_addlast(&tabptr->at_lru, &g_arplru);
+}
+
+/****************************************************************************
+ * Name: arp_replace
+ *
+ * Description:
+ *   Return the entry to be replaced by a new mapping.  This is the tail of
+ *   the LRU list, except that entries that were found since they were last
+ *   moved get a second chance at the head of the list.
+ *
+ * Assumptions:
+ *   The caller holds the table write lock.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_replace(void)
+{
+  FAR struct arp_entry_s *tabptr;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
     {
-      return e2;
+      tabptr = container_of(dq_tail(&g_arplru),
+                            struct arp_entry_s, at_lru);
+      if (!tabptr->at_used)
+        {
+          return tabptr;
+        }
+
+      tabptr->at_used = false;
+      dq_rem(&tabptr->at_lru, &g_arplru);
+      dq_addfirst(&tabptr->at_lru, &g_arplru);
     }
+
+  return container_of(dq_tail(&g_arplru), struct arp_entry_s, at_lru);
 }
 
 /****************************************************************************
@@ -173,32 +272,40 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  *
  * Description:
  *   Find the ARP entry corresponding to this IP address in the ARP table.
+ *   Entries are aged individually; An expired entry is not returned.  It
+ *   stays in the table until it is replaced or updated.
  *
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
  *   dev    - Device structure
+ *   now    - The current time, or zero to return expired entries as well
  *
  * Assumptions:
- *   The network is locked to assure exclusive access to the ARP table.
- *   The return value will become unstable when the network is unlocked.
+ *   The caller holds the table lock.
+ *   The return value will become unstable when the table is unlocked.
  *
  ****************************************************************************/
 
 static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
-                                          FAR struct net_driver_s *dev)
+                                          FAR struct net_driver_s *dev,
+                                          clock_t now)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR hash_node_t *node;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  hashtable_for_every_possible(g_arphash, node, ARP_HASH_KEY(ipaddr))
     {
-      tabptr = &g_arptable[i];
+      tabptr = container_of(node, struct arp_entry_s, at_hash);
       if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
         {
+          if (now != 0 && now - tabptr->at_time > ARP_MAXAGE_TICK)
+            {
+              return NULL;
+            }
+
           return tabptr;
         }
     }
@@ -208,6 +315,104 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_refresh_finish and arp_refresh_work
+ *
+ * Description:
+ *   Send ARP requests for the entries that are still in use shortly
+ *   before they expire, so that the traffic to these hosts is not stalled
+ *   by a new ARP resolution.  The reply updates the entry in the table.
+ *
+ ****************************************************************************/
+
+#ifdef ARP_REFRESH
+static void arp_refresh_finish(FAR struct net_driver_s *dev, int result)
+{
+  if (result < 0)
+    {
+      ninfo("ARP refresh failed: %d\n", result);
+    }
+}
+
+static void arp_refresh_work(FAR void *arg)
+{
+  in_addr_t ipaddr;
+  int i;
+
+  net_lock();
+
+  for (; ; )
+    {
+      /* Take the pending requests one at a time: The table lock may not be
+       * held while sending.
+       */
+
+      ipaddr = 0;
+      net_table_wrlock();
+      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+        {
+          if (g_arptable[i].at_refresh != ARP_REFRESH_PENDING)
+            {
+              continue;
+            }
+
+          /* The entry may have been released since it was queued */
+
+          if (g_arptable[i].at_ipaddr == 0)
+            {
+              g_arptable[i].at_refresh = ARP_REFRESH_NONE;
+              continue;
+            }
+
+          g_arptable[i].at_refresh = ARP_REFRESH_SENT;
+          ipaddr = g_arptable[i].at_ipaddr;
+          break;
+        }
+
+      net_table_wrunlock();
+
+      if (ipaddr == 0)
+        {
+          break;
+        }
+
+      arp_send_async(ipaddr, arp_refresh_finish);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: arp_refresh
+ *
+ * Description:
+ *   Queue the background refresh of an entry that is about to expire.  The
+ *   entry is looked up again, because it may have been updated or replaced
+ *   since the caller released the table lock.
+ *
+ ****************************************************************************/
+
+static void arp_refresh(in_addr_t ipaddr, FAR struct net_driver_s *dev,
+                        clock_t now)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  net_table_wrlock();
+  tabptr = arp_lookup(ipaddr, dev, now);
+  if (tabptr != NULL && tabptr->at_refresh == ARP_REFRESH_NONE &&
+      now - tabptr->at_time > ARP_MAXAGE_TICK - ARP_REFRESH_TICK)
+    {
+      tabptr->at_refresh = ARP_REFRESH_PENDING;
+      if (work_available(&g_arprefresh))
+        {
+          work_queue(LPWORK, &g_arprefresh, arp_refresh_work, NULL, 0);
+        }
+    }
+
+  net_table_wrunlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -236,45 +441,43 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_entry_s *tabptr;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  net_table_wrlock();
+  arp_table_init();
+
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping replaces the least recently used entry.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_lookup(ipaddr, dev, 0);
+  if (tabptr == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+      tabptr = arp_replace();
+      arp_release(tabptr);
 
-          tabptr = &g_arptable[i];
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      tabptr->at_ipaddr = ipaddr;
+      hashtable_add(g_arphash, &tabptr->at_hash, ARP_HASH_KEY(ipaddr));
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
+#ifdef ARP_REFRESH
+  tabptr->at_refresh = ARP_REFRESH_NONE;
+#endif
+
+  /* Make it the most recently used entry */
+
+  tabptr->at_used = false;
+  dq_rem(&tabptr->at_lru, &g_arplru);
+  dq_addfirst(&tabptr->at_lru, &g_arplru);
+
+  net_table_wrunlock();
   return OK;
 }
 
@@ -334,10 +537,17 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 {
   FAR struct arp_entry_s *tabptr;
   struct arp_table_info_s info;
+  clock_t now = clock_systime_ticks();
+#ifdef ARP_REFRESH
+  bool refresh;
+#endif
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in the ARP table.  A hit only
+   * marks the entry as used, so the table is locked for reading.
+   */
 
-  tabptr = arp_lookup(ipaddr, dev);
+  net_table_rdlock();
+  tabptr = arp_lookup(ipaddr, dev, now);
   if (tabptr != NULL)
     {
       /* Yes.. return the Ethernet MAC address if the caller has provided a
@@ -349,6 +559,24 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
           memcpy(ethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
         }
 
+      tabptr->at_used = true;
+
+#ifdef ARP_REFRESH
+      refresh = tabptr->at_refresh == ARP_REFRESH_NONE &&
+                now - tabptr->at_time > ARP_MAXAGE_TICK - ARP_REFRESH_TICK;
+#endif
+
+      net_table_rdunlock();
+
+#ifdef ARP_REFRESH
+      /* Refresh the entry in the background if it is about to expire */
+
+      if (refresh)
+        {
+          arp_refresh(ipaddr, dev, now);
+        }
+#endif
+
       /* Return success in any case meaning that a valid Ethernet MAC
        * address mapping is available for the IP address.
        */
@@ -356,6 +584,8 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
       return OK;
     }
 
+  net_table_rdunlock();
+
   /* No.. check if the IPv4 address is the address assigned to a local
    * Ethernet network device.  If so, return a mapping of that IP address
    * to the Ethernet MAC address assigned to the network device.
@@ -392,19 +622,28 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
+  int ret = -ENOENT;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr, dev);
+  net_table_wrlock();
+  tabptr = arp_lookup(ipaddr, dev, 0);
   if (tabptr != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Release the entry to "delete" it.  An expired entry is
+       * released as well, but it is reported as not found.
+       */
 
-      tabptr->at_ipaddr = 0;
-      return OK;
+      if (clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+        {
+          ret = OK;
+        }
+
+      arp_release(tabptr);
     }
 
-  return -ENOENT;
+  net_table_wrunlock();
+  return ret;
 }
 
 /****************************************************************************
@@ -425,13 +664,19 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 {
   int i;
 
+  net_table_wrlock();
+  arp_table_init();
+
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
       if (dev == g_arptable[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(&g_arptable[i]);
+          g_arptable[i].at_dev = NULL;
         }
     }
+
+  net_table_wrunlock();
 }
 
 /****************************************************************************
@@ -466,6 +711,7 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
 
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
+  net_table_rdlock();
   for (i = 0, now = clock_systime_ticks(), ncopied = 0;
        nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
        i++)
@@ -488,6 +734,8 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
         }
     }
 
+  net_table_rdunlock();
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
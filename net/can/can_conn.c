@@ -152,6 +152,8 @@ FAR struct can_conn_s *can_alloc(void)
       conn->filter_count = 1;
 #endif
 
+      nxrmutex_init(&conn->sconn.s_lock);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_can_connections);
@@ -181,6 +183,7 @@ void can_free(FAR struct can_conn_s *conn)
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_can_connections);
+  nxrmutex_destroy(&conn->sconn.s_lock);
 
   /* If this is a preallocated or a batch allocated connection store it in
    * the free connections list. Else free it.
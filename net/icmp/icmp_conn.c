@@ -136,6 +136,8 @@ FAR struct icmp_conn_s *icmp_alloc(void)
       conn = (FAR struct icmp_conn_s *)dq_remfirst(&g_free_icmp_connections);
       if (conn != NULL)
         {
+          nxrmutex_init(&conn->sconn.s_lock);
+
           /* Enqueue the connection into the active list */
 
           dq_addlast(&conn->sconn.node, &g_active_icmp_connections);
@@ -181,6 +183,7 @@ void icmp_free(FAR struct icmp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_icmp_connections);
+      nxrmutex_destroy(&conn->sconn.s_lock);
 
       /* If this is a preallocated or a batch allocated connection store it
        * in the free connections list. Else free it.
@@ -41,8 +41,8 @@
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+/* This is the Neighbor table.  The table lock (net_table_rdlock() or
+ * net_table_wrlock()) must be held when accessing this table.
  */
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
@@ -67,6 +67,10 @@ struct net_driver_s; /* Forward reference */
  *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
  *   returned if there is no matching entry in the Neighbor Table.
  *
+ * Assumptions:
+ *   The caller holds the table lock.  The returned entry becomes unstable
+ *   when the table is unlocked.
+ *
  ****************************************************************************/
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
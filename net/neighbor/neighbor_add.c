@@ -75,6 +75,8 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
    * check might be to compare ne_ipaddr with the IPv6 unspecified address.
    */
 
+  net_table_wrlock();
+
   oldest_time = g_neighbors[0].ne_time;
   oldest_ndx  = 0;
   lltype      = dev->d_lltype;
@@ -112,4 +114,6 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   /* Dump the contents of the new entry */
 
   neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+
+  net_table_wrunlock();
 }
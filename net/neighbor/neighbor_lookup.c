@@ -118,6 +118,7 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
 
   /* Check if the IPv6 address is already in the neighbor table. */
 
+  net_table_rdlock();
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
@@ -134,9 +135,12 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
        * address mapping is available for the IPv6 address.
        */
 
+      net_table_rdunlock();
       return OK;
     }
 
+  net_table_rdunlock();
+
   /* No.. check if the IPv6 address is the address assigned to a local
    * network device.  If so, return a mapping of that IPv6 address
    * to the linker layer address assigned to the network device.
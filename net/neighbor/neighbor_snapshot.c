@@ -66,6 +66,7 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
 
   /* Copy all non-empty entries in the Neighbor table. */
 
+  net_table_rdlock();
   for (i = 0, ncopied = 0;
        nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
        i++)
@@ -85,6 +86,8 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
         }
     }
 
+  net_table_rdunlock();
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
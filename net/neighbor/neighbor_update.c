@@ -50,9 +50,12 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
 {
   struct neighbor_entry_s *neighbor;
 
+  net_table_wrlock();
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systime_ticks();
     }
+
+  net_table_wrunlock();
 }
@@ -184,8 +184,10 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
    * multiple devices.
    */
 
+  net_table_rdlock();
   ne   = neighbor_findentry(lipaddr);
   hint = ne ? ne->ne_dev : NULL;
+  net_table_rdunlock();
 #endif
 
   /* Examine each registered network device */
@@ -81,6 +81,19 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+  /* Index the new entry for the longest prefix match */
+
+  if (net_trie_addroute_ipv4((FAR struct net_route_ipv4_entry_s *)route)
+      < 0)
+    {
+      net_unlock();
+      nerr("ERROR:  Failed to index the route\n");
+      net_freeroute_ipv4(route);
+      return -ENOMEM;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
@@ -116,6 +129,19 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lock();
 
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+  /* Index the new entry for the longest prefix match */
+
+  if (net_trie_addroute_ipv6((FAR struct net_route_ipv6_entry_s *)route)
+      < 0)
+    {
+      net_unlock();
+      nerr("ERROR:  Failed to index the route\n");
+      net_freeroute_ipv6(route);
+      return -ENOMEM;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
@@ -128,6 +128,12 @@ void net_init_ramroute(void)
       ramroute_ipv6_addlast(&g_prealloc_ipv6routes[i], &g_free_ipv6routes);
     }
 #endif
+
+#if defined(CONFIG_ROUTE_IPv4_TRIE) || defined(CONFIG_ROUTE_IPv6_TRIE)
+  /* Initialize the longest prefix match tries */
+
+  net_init_trieroute();
+#endif
 }
 
 /****************************************************************************
@@ -109,6 +109,12 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+      /* Remove it from the longest prefix match trie */
+
+      net_trie_delroute_ipv4((FAR struct net_route_ipv4_entry_s *)route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -165,6 +171,12 @@ static int net_match_ipv6(
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+      /* Remove it from the longest prefix match trie */
+
+      net_trie_delroute_ipv6((FAR struct net_route_ipv6_entry_s *)route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
@@ -0,0 +1,661 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#if defined(CONFIG_ROUTE_IPv4_TRIE) || defined(CONFIG_ROUTE_IPv6_TRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Keys are stored as arrays of 32-bit words in host order, most significant
+ * bit first.
+ */
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+#  define ROUTE_TRIE_NWORDS 4
+#else
+#  define ROUTE_TRIE_NWORDS 1
+#endif
+
+/* A trie with N prefixes has at most N - 1 branch nodes without routes */
+
+#define ROUTE_TRIE_IPv4_NODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define ROUTE_TRIE_IPv6_NODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the path compressed binary trie.  A node either holds the
+ * routes for exactly its prefix, or, if it has no routes, it is a branch
+ * point with two children.
+ */
+
+struct route_trie_node_s
+{
+  FAR struct route_trie_node_s *parent;    /* NULL for the root node */
+  FAR struct route_trie_node_s *child[2];  /* Subtries for next bit 0/1 */
+  sq_queue_t routes;                       /* Routes with this prefix */
+  uint32_t key[ROUTE_TRIE_NWORDS];         /* Prefix, other bits zero */
+  uint8_t plen;                            /* Prefix length in bits */
+};
+
+struct route_trie_s
+{
+  FAR struct route_trie_node_s *root;      /* The root of the trie */
+  FAR struct route_trie_node_s *free;      /* Free nodes, via child[0] */
+};
+
+typedef CODE int (*route_trie_handler_t)(FAR sq_entry_t *route,
+                                         FAR void *arg);
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+struct route_trie_ipv4_s
+{
+  route_handler_ipv4_t handler;            /* The caller's handler */
+  FAR void *arg;                           /* And its argument */
+};
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+struct route_trie_ipv6_s
+{
+  route_handler_ipv6_t handler;            /* The caller's handler */
+  FAR void *arg;                           /* And its argument */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+static struct route_trie_s g_ipv4_trie;
+static struct route_trie_node_s g_ipv4_trienodes[ROUTE_TRIE_IPv4_NODES];
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+static struct route_trie_s g_ipv6_trie;
+static struct route_trie_node_s g_ipv6_trienodes[ROUTE_TRIE_IPv6_NODES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: route_trie_bit
+ *
+ * Description:
+ *   Return the value of bit 'bit' of the key, counting from the most
+ *   significant bit.
+ *
+ ****************************************************************************/
+
+static inline int route_trie_bit(FAR const uint32_t *key, unsigned int bit)
+{
+  return (key[bit >> 5] >> (31 - (bit & 31))) & 1;
+}
+
+/****************************************************************************
+ * Name: route_trie_common
+ *
+ * Description:
+ *   Return the length of the common prefix of two keys, limited to
+ *   'maxbits'.
+ *
+ ****************************************************************************/
+
+static unsigned int route_trie_common(FAR const uint32_t *key1,
+                                      FAR const uint32_t *key2,
+                                      unsigned int maxbits)
+{
+  unsigned int bits = 0;
+  uint32_t diff;
+  int i;
+
+  for (i = 0; bits < maxbits; i++)
+    {
+      diff = key1[i] ^ key2[i];
+      if (diff != 0)
+        {
+          bits += 32 - fls((int)diff);
+          break;
+        }
+
+      bits += 32;
+    }
+
+  return MIN(bits, maxbits);
+}
+
+/****************************************************************************
+ * Name: route_trie_alloc and route_trie_release
+ *
+ * Description:
+ *   Get a node for the prefix 'key'/'plen' from the free list, or return a
+ *   node to the free list.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+route_trie_alloc(FAR struct route_trie_s *trie, FAR const uint32_t *key,
+                 unsigned int plen)
+{
+  FAR struct route_trie_node_s *node = trie->free;
+  unsigned int bits = plen;
+  int i;
+
+  if (node != NULL)
+    {
+      trie->free = node->child[0];
+      memset(node, 0, sizeof(struct route_trie_node_s));
+      node->plen = plen;
+
+      for (i = 0; i < ROUTE_TRIE_NWORDS && bits > 0; i++)
+        {
+          if (bits >= 32)
+            {
+              node->key[i] = key[i];
+              bits -= 32;
+            }
+          else
+            {
+              node->key[i] = key[i] & ~(UINT32_MAX >> bits);
+              bits = 0;
+            }
+        }
+    }
+
+  return node;
+}
+
+static void route_trie_release(FAR struct route_trie_s *trie,
+                               FAR struct route_trie_node_s *node)
+{
+  node->child[0] = trie->free;
+  trie->free     = node;
+}
+
+/****************************************************************************
+ * Name: route_trie_init
+ *
+ * Description:
+ *   Initialize an empty trie using the provided nodes.
+ *
+ ****************************************************************************/
+
+static void route_trie_init(FAR struct route_trie_s *trie,
+                            FAR struct route_trie_node_s *nodes,
+                            unsigned int nnodes)
+{
+  unsigned int i;
+
+  trie->root = NULL;
+  trie->free = NULL;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      route_trie_release(trie, &nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: route_trie_replace
+ *
+ * Description:
+ *   Put 'node' (which may be NULL) in the place of 'old' in the trie.
+ *
+ ****************************************************************************/
+
+static void route_trie_replace(FAR struct route_trie_s *trie,
+                               FAR struct route_trie_node_s *old,
+                               FAR struct route_trie_node_s *node)
+{
+  FAR struct route_trie_node_s *parent = old->parent;
+
+  if (parent == NULL)
+    {
+      trie->root = node;
+    }
+  else
+    {
+      parent->child[parent->child[1] == old] = node;
+    }
+
+  if (node != NULL)
+    {
+      node->parent = parent;
+    }
+}
+
+/****************************************************************************
+ * Name: route_trie_insert
+ *
+ * Description:
+ *   Add a route with the prefix 'key'/'plen' to the trie.  Routes with the
+ *   same prefix are kept in the order they were added.
+ *
+ ****************************************************************************/
+
+static int route_trie_insert(FAR struct route_trie_s *trie,
+                             FAR const uint32_t *key, unsigned int plen,
+                             FAR sq_entry_t *route)
+{
+  FAR struct route_trie_node_s *parent = NULL;
+  FAR struct route_trie_node_s *node = trie->root;
+  FAR struct route_trie_node_s *leaf;
+  FAR struct route_trie_node_s *branch;
+  unsigned int common = 0;
+
+  /* Descend as long as the node prefix is a prefix of the new one */
+
+  while (node != NULL)
+    {
+      common = route_trie_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          sq_addlast(route, &node->routes);
+          return OK;
+        }
+
+      parent = node;
+      node   = node->child[route_trie_bit(key, node->plen)];
+    }
+
+  leaf = route_trie_alloc(trie, key, plen);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  sq_addlast(route, &leaf->routes);
+
+  if (node == NULL)
+    {
+      /* Append the new prefix below the longest covering node */
+
+      leaf->parent = parent;
+      if (parent == NULL)
+        {
+          trie->root = leaf;
+        }
+      else
+        {
+          parent->child[route_trie_bit(key, parent->plen)] = leaf;
+        }
+    }
+  else if (common == plen)
+    {
+      /* The new prefix covers the node: Insert it above the node */
+
+      route_trie_replace(trie, node, leaf);
+      leaf->child[route_trie_bit(node->key, plen)] = node;
+      node->parent = leaf;
+    }
+  else
+    {
+      /* The prefixes diverge: Join them with a new branch node */
+
+      branch = route_trie_alloc(trie, key, common);
+      if (branch == NULL)
+        {
+          route_trie_release(trie, leaf);
+          return -ENOMEM;
+        }
+
+      route_trie_replace(trie, node, branch);
+      branch->child[route_trie_bit(key, common)]       = leaf;
+      branch->child[route_trie_bit(node->key, common)] = node;
+      leaf->parent = branch;
+      node->parent = branch;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: route_trie_remove
+ *
+ * Description:
+ *   Remove a route with the prefix 'key'/'plen' from the trie.  Nodes that
+ *   are left without routes and are no longer needed as a branch point are
+ *   released.
+ *
+ ****************************************************************************/
+
+static void route_trie_remove(FAR struct route_trie_s *trie,
+                              FAR const uint32_t *key, unsigned int plen,
+                              FAR sq_entry_t *route)
+{
+  FAR struct route_trie_node_s *node = trie->root;
+  FAR struct route_trie_node_s *parent;
+
+  /* Find the node with exactly this prefix */
+
+  while (node != NULL && node->plen < plen &&
+         route_trie_common(node->key, key, node->plen) == node->plen)
+    {
+      node = node->child[route_trie_bit(key, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen ||
+      route_trie_common(node->key, key, plen) != plen)
+    {
+      return;
+    }
+
+  sq_rem(route, &node->routes);
+
+  while (node != NULL && sq_empty(&node->routes) &&
+         (node->child[0] == NULL || node->child[1] == NULL))
+    {
+      parent = node->parent;
+      route_trie_replace(trie, node, node->child[0] != NULL ?
+                         node->child[0] : node->child[1]);
+      route_trie_release(trie, node);
+      node = parent;
+    }
+}
+
+/****************************************************************************
+ * Name: route_trie_match
+ *
+ * Description:
+ *   Call the handler for each route that covers 'key', from the longest to
+ *   the shortest prefix.
+ *
+ ****************************************************************************/
+
+static int route_trie_match(FAR struct route_trie_s *trie,
+                            FAR const uint32_t *key, unsigned int nbits,
+                            route_trie_handler_t handler, FAR void *arg)
+{
+  FAR struct route_trie_node_s *node = trie->root;
+  FAR struct route_trie_node_s *last = NULL;
+  FAR sq_entry_t *route;
+  int ret;
+
+  /* Find the longest matching prefix.  All of its ancestors match too. */
+
+  while (node != NULL &&
+         route_trie_common(node->key, key, node->plen) == node->plen)
+    {
+      last = node;
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->child[route_trie_bit(key, node->plen)];
+    }
+
+  for (node = last; node != NULL; node = node->parent)
+    {
+      for (route = sq_peek(&node->routes); route != NULL;
+           route = sq_next(route))
+        {
+          ret = handler(route, arg);
+          if (ret != 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: route_trie_ipv4_key and route_trie_ipv6_key
+ *
+ * Description:
+ *   Convert an address in network order to a trie key.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+static void route_trie_ipv4_key(in_addr_t addr, FAR uint32_t *key)
+{
+  memset(key, 0, ROUTE_TRIE_NWORDS * sizeof(uint32_t));
+  key[0] = NTOHL(addr);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+static void route_trie_ipv6_key(FAR const uint16_t *addr, FAR uint32_t *key)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      key[i] = ((uint32_t)NTOHS(addr[2 * i]) << 16) |
+               NTOHS(addr[2 * i + 1]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: route_trie_ipv4_handler and route_trie_ipv6_handler
+ *
+ * Description:
+ *   Pass the routing table entry of a trie match to the caller's handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+static int route_trie_ipv4_handler(FAR sq_entry_t *route, FAR void *arg)
+{
+  FAR struct route_trie_ipv4_s *info = arg;
+
+  return info->handler(&container_of(route, struct net_route_ipv4_entry_s,
+                                     tlink)->entry, info->arg);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+static int route_trie_ipv6_handler(FAR sq_entry_t *route, FAR void *arg)
+{
+  FAR struct route_trie_ipv6_s *info = arg;
+
+  return info->handler(&container_of(route, struct net_route_ipv6_entry_s,
+                                     tlink)->entry, info->arg);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries of the in-memory routing
+ *   tables.
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void)
+{
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+  route_trie_init(&g_ipv4_trie, g_ipv4_trienodes, ROUTE_TRIE_IPv4_NODES);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+  route_trie_init(&g_ipv6_trie, g_ipv6_trienodes, ROUTE_TRIE_IPv6_NODES);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_trie_addroute_ipv4/6 and net_trie_delroute_ipv4/6
+ *
+ * Description:
+ *   Add a routing table entry to the longest prefix match trie or remove
+ *   it.  The table lock is only held for the trie update itself, so that
+ *   the lookups are blocked for a time bounded by the address length.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_trie_addroute_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  uint32_t key[ROUTE_TRIE_NWORDS];
+  int ret;
+
+  route_trie_ipv4_key(route->entry.target, key);
+
+  net_table_wrlock();
+  ret = route_trie_insert(&g_ipv4_trie, key,
+                          net_ipv4_mask2pref(route->entry.netmask),
+                          &route->tlink);
+  net_table_wrunlock();
+  return ret;
+}
+
+void net_trie_delroute_ipv4(FAR struct net_route_ipv4_entry_s *route)
+{
+  uint32_t key[ROUTE_TRIE_NWORDS];
+
+  route_trie_ipv4_key(route->entry.target, key);
+
+  net_table_wrlock();
+  route_trie_remove(&g_ipv4_trie, key,
+                    net_ipv4_mask2pref(route->entry.netmask),
+                    &route->tlink);
+  net_table_wrunlock();
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_trie_addroute_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  uint32_t key[ROUTE_TRIE_NWORDS];
+  int ret;
+
+  route_trie_ipv6_key(route->entry.target, key);
+
+  net_table_wrlock();
+  ret = route_trie_insert(&g_ipv6_trie, key,
+                          net_ipv6_mask2pref(route->entry.netmask),
+                          &route->tlink);
+  net_table_wrunlock();
+  return ret;
+}
+
+void net_trie_delroute_ipv6(FAR struct net_route_ipv6_entry_s *route)
+{
+  uint32_t key[ROUTE_TRIE_NWORDS];
+
+  route_trie_ipv6_key(route->entry.target, key);
+
+  net_table_wrlock();
+  route_trie_remove(&g_ipv6_trie, key,
+                    net_ipv6_mask2pref(route->entry.netmask),
+                    &route->tlink);
+  net_table_wrunlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4/net_lpmroute_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers the target address, from the
+ *   longest to the shortest prefix.
+ *
+ * Input Parameters:
+ *   target  - The destination address to be matched.
+ *   handler - Will be called for each covering route.  It is called with
+ *             the routing table locked and must not take any lock.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all covering routes were visited.  Handlers may
+ *   terminate the search early with any non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg)
+{
+  struct route_trie_ipv4_s info;
+  uint32_t key[ROUTE_TRIE_NWORDS];
+  int ret;
+
+  info.handler = handler;
+  info.arg     = arg;
+  route_trie_ipv4_key(target, key);
+
+  net_table_rdlock();
+  ret = route_trie_match(&g_ipv4_trie, key, 32,
+                         route_trie_ipv4_handler, &info);
+  net_table_rdunlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_lpmroute_ipv6(FAR const uint16_t *target,
+                      route_handler_ipv6_t handler, FAR void *arg)
+{
+  struct route_trie_ipv6_s info;
+  uint32_t key[ROUTE_TRIE_NWORDS];
+  int ret;
+
+  info.handler = handler;
+  info.arg     = arg;
+  route_trie_ipv6_key(target, key);
+
+  net_table_rdlock();
+  ret = route_trie_match(&g_ipv6_trie, key, 128,
+                         route_trie_ipv6_handler, &info);
+  net_table_rdunlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_TRIE || CONFIG_ROUTE_IPv6_TRIE */
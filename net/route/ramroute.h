@@ -27,6 +27,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/queue.h>
+
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -66,6 +68,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+  sq_entry_t tlink;                     /* Link in the trie node */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -84,6 +89,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+  sq_entry_t tlink;                     /* Link in the trie node */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -216,5 +224,57 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries of the in-memory routing
+ *   tables.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ROUTE_IPv4_TRIE) || defined(CONFIG_ROUTE_IPv6_TRIE)
+void net_init_trieroute(void);
+#endif
+
+/****************************************************************************
+ * Name: net_trie_addroute_ipv4/6 and net_trie_delroute_ipv4/6
+ *
+ * Description:
+ *   Add a routing table entry to the longest prefix match trie or remove
+ *   it.  The entries are indexed by their target and the prefix length of
+ *   their netmask.
+ *
+ * Input Parameters:
+ *   route - The routing table entry
+ *
+ * Returned Value:
+ *   net_trie_addroute_ipv4/6() return OK on success or -ENOMEM if no trie
+ *   node is available.
+ *
+ * Assumptions:
+ *   The network is locked.  The routing table lock is taken internally.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_trie_addroute_ipv4(FAR struct net_route_ipv4_entry_s *route);
+void net_trie_delroute_ipv4(FAR struct net_route_ipv4_entry_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_trie_addroute_ipv6(FAR struct net_route_ipv6_entry_s *route);
+void net_trie_delroute_ipv6(FAR struct net_route_ipv6_entry_s *route);
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
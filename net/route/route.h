@@ -281,6 +281,42 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lpmroute_ipv4/net_lpmroute_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers the target address, from the
+ *   longest to the shortest prefix.  Routes with the same prefix are
+ *   visited in the order they were added.  Without a longest prefix match
+ *   trie, this is the same as net_foreachroute_ipv4/6() and all routes are
+ *   visited.
+ *
+ * Input Parameters:
+ *   target  - The destination address to be matched.
+ *   handler - Will be called for each covering route.  It is called with
+ *             the routing table locked and must not take any lock.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all covering routes were visited.  Handlers may
+ *   terminate the search early with any non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_TRIE
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg);
+#elif defined(CONFIG_NET_IPv4)
+#  define net_lpmroute_ipv4(t, h, a) net_foreachroute_ipv4(h, a)
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_TRIE
+int net_lpmroute_ipv6(FAR const uint16_t *target,
+                      route_handler_ipv6_t handler, FAR void *arg);
+#elif defined(CONFIG_NET_IPv6)
+#  define net_lpmroute_ipv6(t, h, a) net_foreachroute_ipv6(h, a)
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
@@ -30,6 +30,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -210,6 +211,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t hash_active; /* Entry in the active connection hashtable */
+  hash_node_t hash_listen; /* Entry in the listener hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -293,6 +298,7 @@ struct tcp_conn_s
   /* Read-ahead buffering.
    *
    *   readahead - An IOB chain where the TCP/IP read-ahead data is retained.
+   *               It is protected by conn_lock(), not by net_lock().
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
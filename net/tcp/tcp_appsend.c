@@ -209,10 +209,15 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else
     {
       /* The application cannot send more than what is allowed by the
-       * MSS (the minimum of the MSS and the available window).
+       * MSS (the minimum of the MSS and the available window), unless the
+       * device segments the packet for us.
        */
 
+#ifdef CONFIG_NET_TCP_GSO
+      DEBUGASSERT(dev->d_sndlen <= conn->mss || dev->d_gso_size != 0);
+#else
       DEBUGASSERT(dev->d_sndlen <= conn->mss);
+#endif
 
 #if !defined(CONFIG_NET_TCP_WRITE_BUFFERS) || defined(CONFIG_NET_SENDFILE)
 
@@ -144,7 +144,9 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
           rcvseq = TCP_SEQ_ADD(rcvseq,
                                seg->data->io_pktlen);
           net_incr32(conn->rcvseq, seg->data->io_pktlen);
+          conn_lock(&conn->sconn);
           net_iob_concat(&conn->readahead, &seg->data);
+          conn_unlock(&conn->sconn);
         }
       else if (TCP_SEQ_GT(rcvseq, seg->left))
         {
@@ -178,7 +180,9 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
                   rcvseq = TCP_SEQ_ADD(rcvseq,
                                        seg->data->io_pktlen);
                   net_incr32(conn->rcvseq, seg->data->io_pktlen);
+                  conn_lock(&conn->sconn);
                   net_iob_concat(&conn->readahead, &seg->data);
+                  conn_unlock(&conn->sconn);
                 }
             }
         }
@@ -402,7 +406,9 @@ uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(&conn->sconn);
 
   /* Clear device buffer */
 
@@ -89,10 +89,115 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The connected TCP connections, hashed by local port, remote port and
+ * remote address.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_active_hash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_ipv4_key, tcp_ipv6_key and tcp_conn_key
+ *
+ * Description:
+ *   Compute the key of a connection in the active connection hashtable
+ *   from its remote address and from both port numbers (in network byte
+ *   order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_key(in_addr_t raddr, uint16_t lport,
+                                    uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_key(FAR const uint16_t *raddr,
+                                    uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+static uint32_t tcp_conn_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_key(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_key(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_first
+ *
+ * Description:
+ *   Return the first connection of the active connection hashtable bucket
+ *   selected by 'key'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_active_first(uint32_t key)
+{
+  FAR hash_node_t *node =
+    g_tcp_active_hash[HASH(key, CONFIG_NET_TCP_CONN_HASH_BITS)].head;
+
+  return node ? container_of(node, struct tcp_conn_s, hash_active) : NULL;
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_active_next
+ *
+ * Description:
+ *   Return the connection following 'conn' among the candidates for an
+ *   incoming segment:  The next connection of the same hashtable bucket if
+ *   CONFIG_NET_TCP_CONN_HASH is enabled, otherwise the next connection of
+ *   the active list.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_active_next(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node = conn->hash_active.flink;
+
+  return node ? container_of(node, struct tcp_conn_s, hash_active) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -187,9 +292,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = tcp_active_first(tcp_ipv4_key(srcipaddr, tcp->destport,
+                                             tcp->srcport));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -226,7 +336,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_active_next(conn);
     }
 
   return conn;
@@ -254,9 +364,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = tcp_active_first(tcp_ipv6_key(*srcipaddr, tcp->destport,
+                                             tcp->srcport));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -293,7 +408,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_active_next(conn);
     }
 
   return conn;
@@ -789,6 +904,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   if (conn)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
+      nxrmutex_init(&conn->sconn.s_lock);
       conn->sconn.ttl     = IP_TTL_DEFAULT;
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -846,8 +962,10 @@ void tcp_free_rx_buffers(FAR struct tcp_conn_s *conn)
 {
   /* Release any read-ahead buffers attached to the connection */
 
+  conn_lock(&conn->sconn);
   iob_free_chain(conn->readahead);
   conn->readahead = NULL;
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Release any out-of-order buffers */
@@ -930,6 +1048,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      hashtable_delete(g_tcp_active_hash, &conn->hash_active,
+                       tcp_conn_key(conn));
+#endif
     }
 
   tcp_free_rx_buffers(conn);
@@ -978,6 +1100,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   /* Mark the connection available. */
 
   conn->tcpstateflags = TCP_CLOSED;
+  nxrmutex_destroy(&conn->sconn.s_lock);
 
   /* If this is a preallocated or a batch allocated connection store it in
    * the free connections list. Else free it.
@@ -1239,6 +1362,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      hashtable_add(g_tcp_active_hash, &conn->hash_active,
+                    tcp_conn_key(conn));
+#endif
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1550,6 +1677,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_add(g_tcp_active_hash, &conn->hash_active, tcp_conn_key(conn));
+#endif
   ret = OK;
 
 errout_with_lock:
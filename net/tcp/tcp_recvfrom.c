@@ -233,7 +233,7 @@ static inline uint16_t tcp_newdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The caller holds the lock of the connection (see conn_lock()).
  *
  ****************************************************************************/
 
@@ -617,22 +617,25 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR struct tcp_conn_s *conn;
   int                    ret;
 
-  net_lock();
-
   conn = psock->s_conn;
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
+  /* Initialize the state structure */
 
   tcp_recvfrom_initialize(conn, buf, len, from, fromlen, &state, flags);
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
-   * socket has been disconnected.
+   * socket has been disconnected.  The read-ahead buffer is protected by
+   * the lock of the connection, so this does not take the network lock.
    */
 
+  conn_lock(&conn->sconn);
   tcp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  /* Lock the network so that nothing happens until we are ready */
+
+  net_lock();
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -712,6 +715,19 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   if (((flags & MSG_WAITALL) != 0 || state.ir_recvlen == 0) &&
       state.ir_buflen > 0)
     {
+      /* More data may have been buffered before the network was locked */
+
+      conn_lock(&conn->sconn);
+      tcp_readahead(&state);
+      conn_unlock(&conn->sconn);
+
+      ret = state.ir_recvlen;
+      if (((flags & MSG_WAITALL) == 0 && state.ir_recvlen != 0) ||
+          state.ir_buflen == 0)
+        {
+          goto out;
+        }
+
       /* Set up the callback in the connection */
 
       state.ir_cb = tcp_callback_alloc(conn);
@@ -752,6 +768,7 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * not only this particular connection.
    */
 
+out:
   if (tcp_should_send_recvwindow(conn))
     {
       netdev_txnotify_dev(conn->dev);
@@ -63,7 +63,10 @@ static uint32_t tcp_calc_rcvsize(FAR struct tcp_conn_s *conn,
   uint32_t recvsize;
   uint32_t desire;
 
+  conn_lock(&conn->sconn);
   recvsize = conn->readahead ? conn->readahead->io_pktlen : 0;
+  conn_unlock(&conn->sconn);
+
   if (conn->rcv_bufs > recvsize)
     {
       desire = conn->rcv_bufs - recvsize;
@@ -154,6 +157,7 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
    * (ignoring competition with other IOB consumers).
    */
 
+  conn_lock(&conn->sconn);
   if (conn->readahead != NULL)
     {
       tailroom = iob_tailroom(conn->readahead);
@@ -217,6 +221,7 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
       recvwndo = tailroom;
     }
 
+  conn_unlock(&conn->sconn);
   recvwndo = tcp_calc_rcvsize(conn, recvwndo);
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
@@ -47,6 +47,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -101,6 +102,41 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_gso_prepare
+ *
+ * Description:
+ *   Decide whether the outgoing segment is handed to the device for
+ *   segmentation.  That is only the case if the buffered send logic asked
+ *   for it and the packet really exceeds the MTU of a device that does not
+ *   loop it back to ourself.  The TCP checksum of such a packet is computed
+ *   per segment by the segmentation logic.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Returned Value:
+ *   true if the packet is to be segmented by the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+static bool tcp_gso_prepare(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+  if (dev->d_gso_size != 0 && dev->d_len > devif_get_mtu(dev) &&
+      !devif_is_loopback(dev))
+    {
+      dev->d_gso_size = conn->mss;
+      return true;
+    }
+
+  dev->d_gso_size = 0;
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -189,7 +225,13 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+#ifdef CONFIG_NET_TCP_GSO
+      if (!tcp_gso_prepare(dev, conn))
+#endif
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
 #endif
@@ -209,7 +251,13 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+#ifdef CONFIG_NET_TCP_GSO
+      if (!tcp_gso_prepare(dev, conn))
+#endif
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
 #endif
@@ -407,6 +407,45 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_send_maxlen
+ *
+ * Description:
+ *   Return the largest amount of new data that may be sent in one packet.
+ *   This is the MSS, or a multiple of it if the device is able to segment
+ *   large TCP packets itself.
+ *
+ * Input Parameters:
+ *   dev   The structure of the network driver used to send the data
+ *   conn  The TCP connection structure
+ *
+ * Returned Value:
+ *   The maximum number of payload bytes of the next packet.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_maxlen(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_GSO
+  uint32_t hdrlen = tcpip_hdrsize(conn);
+
+  if (dev->d_gso_maxsegs > 1 && dev->d_gso_maxsize > hdrlen + conn->mss)
+    {
+      uint32_t nsegs = (dev->d_gso_maxsize - hdrlen) / conn->mss;
+
+      if (nsegs > dev->d_gso_maxsegs)
+        {
+          nsegs = dev->d_gso_maxsegs;
+        }
+
+      return nsegs * conn->mss;
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -1011,9 +1050,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_send_maxlen(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_send_maxlen(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1063,6 +1102,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           tcp_ip_select(conn);
 #endif
+#ifdef CONFIG_NET_TCP_GSO
+          /* Ask for segmentation by the device if the packet carries more
+           * than one MSS of data.  tcp_send() will clear the request again
+           * if the packet turns out to fit into the MTU anyway.
+           */
+
+          dev->d_gso_size = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           /* Then set-up to send that amount of data with the offset
            * corresponding to the amount of data already sent. (this
            * won't actually happen until the polling cycle completes).
@@ -1072,6 +1120,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NET_TCP_GSO
+              dev->d_gso_size = 0;
+#endif
               return flags;
             }
 
@@ -1163,6 +1214,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* or one full offloaded segment, if that is larger */
+
+  if (size < CONFIG_NET_TCP_GSO_MAXSIZE)
+    {
+      size = CONFIG_NET_TCP_GSO_MAXSIZE;
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
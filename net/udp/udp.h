@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -110,6 +111,10 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  hash_node_t hash_node;  /* Entry in the connection hashtable */
+  uint32_t hash_key;      /* Key of the connection in the hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -128,6 +133,7 @@ struct udp_conn_s
   /* Read-ahead buffering.
    *
    *   readahead - An IOB chain where the UDP/IP read-ahead data is retained.
+   *               It is protected by conn_lock(), not by net_lock().
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
@@ -252,6 +258,24 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_rehash
+ *
+ * Description:
+ *   Move the connection to the hashtable bucket matching its current local
+ *   address and port.  Must be called each time that either is changed.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+void udp_rehash(FAR struct udp_conn_s *conn);
+#else
+#  define udp_rehash(conn)
+#endif
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -77,14 +77,22 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   int offset;
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
+  /* The read-ahead buffer is protected by the connection lock only, see
+   * psock_udp_recvfrom().
+   */
+
+  conn_lock(&conn->sconn);
   if (conn->readahead && conn->readahead->io_pktlen > conn->rcvbufs)
     {
+      conn_unlock(&conn->sconn);
       netdev_iob_release(dev);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.drop++;
 #endif
       return 0;
     }
+
+  conn_unlock(&conn->sconn);
 #endif
 
   iob = dev->d_iob;
@@ -214,7 +222,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
@@ -90,47 +90,270 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* All UDP connections, hashed by local port and local address */
+
+static DECLARE_HASHTABLE(g_udp_conn_hash, CONFIG_NET_UDP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: udp_find_conn()
+ * Name: udp_ipv4_key and udp_ipv6_key
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Fold an IP address and a port number (in network byte order) into a
+ *   32-bit key.  Used to select the hashtable bucket of a local binding and
+ *   to compute the flow hash of a received datagram.
  *
- * Input Parameters:
- *   domain - IP domain (PF_INET or PF_INET6)
- *   ipaddr - The IP address to use in the lookup
- *   portno - The port to use in the lookup
- *   opt    - The option from another conn to match the conflict conn
- *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t udp_ipv4_key(in_addr_t addr, uint16_t port)
+{
+  return NTOHL(addr) ^ port;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t udp_ipv6_key(FAR const uint16_t *addr,
+                                    uint16_t port)
+{
+  uint32_t key = port;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)addr[i] << 16) | addr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/****************************************************************************
+ * Name: udp_binding_key
+ *
+ * Description:
+ *   Return the hashtable key of a local address and port binding.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_binding_key(uint8_t domain,
+                                FAR const union ip_binding_u *u,
+                                uint16_t portno)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#endif
+    {
+      return udp_ipv4_key(u->ipv4.laddr, portno);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return udp_ipv6_key(u->ipv6.laddr, portno);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_wildcard_key
+ *
+ * Description:
+ *   Return the hashtable key of the wildcard local address on this port.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_wildcard_key(uint8_t domain, uint16_t portno)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#endif
+    {
+      return udp_ipv4_key(INADDR_ANY, portno);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return udp_ipv6_key(g_ipv6_unspecaddr, portno);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_active_first
+ *
+ * Description:
+ *   Return the first connection of the hashtable bucket selected by 'key'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *udp_active_first(uint32_t key)
+{
+  FAR hash_node_t *node =
+    g_udp_conn_hash[HASH(key, CONFIG_NET_UDP_CONN_HASH_BITS)].head;
+
+  return node ? container_of(node, struct udp_conn_s, hash_node) : NULL;
+}
+#endif /* CONFIG_NET_UDP_CONN_HASH */
+
+/****************************************************************************
+ * Name: udp_active_next
+ *
+ * Description:
+ *   Return the connection following 'conn' in the same hashtable bucket if
+ *   CONFIG_NET_UDP_CONN_HASH is enabled, otherwise in the active list.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+  udp_active_next(FAR struct udp_conn_s *conn)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR hash_node_t *node = conn->hash_node.flink;
+
+  return node ? container_of(node, struct udp_conn_s, hash_node) : NULL;
+#else
+  return (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   'conn' is the first connection matching a received datagram and has
+ *   SO_REUSEPORT set.  All the unconnected SO_REUSEPORT sockets bound to
+ *   the same local address and port follow it in the same list.  Select one
+ *   of them using the flow hash of the datagram, so that a given flow is
+ *   always delivered to the same socket.
  *
  * Assumptions:
  *   This function must be called with the network locked.
  *
  ****************************************************************************/
 
-static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reuseport_member(FAR struct udp_conn_s *conn,
+                                 FAR struct udp_conn_s *member)
+{
+  if (!_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(member->flags) || member->lport != conn->lport)
+    {
+      return false;
+    }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (member->domain != conn->domain)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(member->u.ipv4.laddr, conn->u.ipv4.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(member->u.ipv6.laddr, conn->u.ipv6.laddr);
+    }
+#endif
+}
+
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct udp_conn_s *conn, uint32_t flowhash)
+{
+  FAR struct udp_conn_s *member;
+  uint32_t nmembers = 0;
+  uint32_t ndx;
+
+  /* A connected socket only receives its own flow */
+
+  if (_UDP_ISCONNECTMODE(conn->flags))
+    {
+      return conn;
+    }
+
+  for (member = conn; member != NULL; member = udp_active_next(member))
+    {
+      if (udp_reuseport_member(conn, member))
+        {
+          nmembers++;
+        }
+    }
+
+  /* Scale the mixed flow hash to [0, nmembers) */
+
+  ndx = ((uint64_t)(flowhash * GOLDEN_RATIO_32) * nmembers) >> 32;
+
+  for (member = conn; member != NULL; member = udp_active_next(member))
+    {
+      if (udp_reuseport_member(conn, member) && ndx-- == 0)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
+/****************************************************************************
+ * Name: udp_find_next
+ *
+ * Description:
+ *   Search the UDP connection that uses this local port number, starting
+ *   from 'conn'.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *udp_find_next(FAR struct udp_conn_s *conn,
+                                            uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
                                             uint16_t portno, sockopt_t opt)
 {
-  FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
   /* Now search each connection structure. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  for (; conn != NULL; conn = udp_active_next(conn))
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
-       * address and port.
+       * address and port.  The same goes for SO_REUSEPORT, which allows
+       * several sockets to share one port.
        */
 
 #ifdef CONFIG_NET_SOCKOPTS
-      if (skip_reusable && _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR))
+      if ((skip_reusable &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR)) ||
+          (skip_reuseport &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT)))
         {
           continue;
         }
@@ -175,11 +398,57 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 }
 
 /****************************************************************************
- * Name: udp_ipv4_active
+ * Name: udp_find_conn()
+ *
+ * Description:
+ *   Find the UDP connection that uses this local port number.
+ *
+ * Input Parameters:
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *   ipaddr - The IP address to use in the lookup
+ *   portno - The port to use in the lookup
+ *   opt    - The option from another conn to match the conflict conn
+ *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: Likewise.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
+                                            FAR union ip_binding_u *ipaddr,
+                                            uint16_t portno, sockopt_t opt)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR struct udp_conn_s *conn;
+
+  /* Only the connections bound to the same address or to the wildcard
+   * address can conflict.
+   */
+
+  conn = udp_find_next(udp_active_first(udp_binding_key(domain, ipaddr,
+                                                        portno)),
+                       domain, ipaddr, portno, opt);
+  if (conn == NULL)
+    {
+      conn = udp_find_next(udp_active_first(udp_wildcard_key(domain,
+                                                             portno)),
+                           domain, ipaddr, portno, opt);
+    }
+
+  return conn;
+#else
+  return udp_find_next(udp_nextconn(NULL), domain, ipaddr, portno, opt);
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_ipv4_find
  *
  * Description:
  *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   used within the provided UDP header, starting from 'conn'.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -187,16 +456,14 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+static FAR struct udp_conn_s *
+  udp_ipv4_find(FAR struct udp_conn_s *conn, FAR struct ipv4_hdr_s *ip,
+                FAR struct udp_hdr_s *udp)
 {
 #ifdef CONFIG_NET_BROADCAST
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
-  FAR struct ipv4_hdr_s *ip = IPv4BUF;
-  FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -309,15 +576,14 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_active_next(conn);
     }
 
   return conn;
 }
-#endif /* CONFIG_NET_IPv4 */
 
 /****************************************************************************
- * Name: udp_ipv6_active
+ * Name: udp_ipv4_active
  *
  * Description:
  *   Find a connection structure that is the appropriate connection to be
@@ -328,14 +594,59 @@ static inline FAR struct udp_conn_s *
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
 static inline FAR struct udp_conn_s *
-  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
 {
-  FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  /* Sockets bound to the destination address take precedence over the
+   * sockets bound to INADDR_ANY.
+   */
+
+  conn = udp_ipv4_find(udp_active_first(
+           udp_ipv4_key(net_ip4addr_conv32(ip->destipaddr), udp->destport)),
+           ip, udp);
+  if (conn == NULL)
+    {
+      conn = udp_ipv4_find(udp_active_first(
+               udp_ipv4_key(INADDR_ANY, udp->destport)), ip, udp);
+    }
+#else
+  conn = udp_ipv4_find(udp_nextconn(NULL), ip, udp);
+#endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (conn != NULL && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      conn = udp_reuseport_select(conn,
+               udp_ipv4_key(net_ip4addr_conv32(ip->srcipaddr),
+                            udp->srcport));
+    }
+#endif
+
+  return conn;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: udp_ipv6_find
+ *
+ * Description:
+ *   Find a connection structure that is the appropriate connection to be
+ *   used within the provided UDP header, starting from 'conn'.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static FAR struct udp_conn_s *
+  udp_ipv6_find(FAR struct udp_conn_s *conn, FAR struct ipv6_hdr_s *ip,
+                FAR struct udp_hdr_s *udp)
+{
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -448,11 +759,56 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_active_next(conn);
     }
 
   return conn;
 }
+
+/****************************************************************************
+ * Name: udp_ipv6_active
+ *
+ * Description:
+ *   Find a connection structure that is the appropriate connection to be
+ *   used within the provided UDP header
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+{
+  FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR struct udp_conn_s *conn;
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  /* Sockets bound to the destination address take precedence over the
+   * sockets bound to the IPv6 unspecified address.
+   */
+
+  conn = udp_ipv6_find(udp_active_first(
+           udp_ipv6_key(ip->destipaddr, udp->destport)), ip, udp);
+  if (conn == NULL)
+    {
+      conn = udp_ipv6_find(udp_active_first(
+               udp_ipv6_key(g_ipv6_unspecaddr, udp->destport)), ip, udp);
+    }
+#else
+  conn = udp_ipv6_find(udp_nextconn(NULL), ip, udp);
+#endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (conn != NULL && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      conn = udp_reuseport_select(conn,
+               udp_ipv6_key(ip->srcipaddr, udp->srcport));
+    }
+#endif
+
+  return conn;
+}
 #endif /* CONFIG_NET_IPv6 */
 
 /****************************************************************************
@@ -637,6 +993,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
     {
       /* Make sure that the connection is marked as uninitialized */
 
+      nxrmutex_init(&conn->sconn.s_lock);
       conn->sconn.ttl = IP_TTL_DEFAULT;
       conn->flags     = 0;
 #if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
@@ -660,6 +1017,11 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_udp_connections);
+#ifdef CONFIG_NET_UDP_CONN_HASH
+      conn->hash_key = udp_binding_key(domain, &conn->u, conn->lport);
+      hashtable_addlast(g_udp_conn_hash, &conn->hash_node,
+                        conn->hash_key);
+#endif
     }
 
   nxmutex_unlock(&g_free_lock);
@@ -691,10 +1053,14 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_udp_connections);
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  hashtable_delete(g_udp_conn_hash, &conn->hash_node, conn->hash_key);
+#endif
 
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+  nxrmutex_destroy(&conn->sconn.s_lock);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -791,6 +1157,36 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_rehash
+ *
+ * Description:
+ *   Move the connection to the hashtable bucket matching its current local
+ *   address and port.  Must be called each time that either is changed.
+ *   Connections are appended to their bucket, so that of several bindings
+ *   that match a datagram the oldest one wins, as with the linear list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+void udp_rehash(FAR struct udp_conn_s *conn)
+{
+  uint32_t key;
+
+  net_lock();
+
+  key = udp_binding_key(conn->domain, &conn->u, conn->lport);
+  if (key != conn->hash_key)
+    {
+      hashtable_delete(g_udp_conn_hash, &conn->hash_node, conn->hash_key);
+      hashtable_addlast(g_udp_conn_hash, &conn->hash_node, key);
+      conn->hash_key = key;
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -957,6 +1353,9 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
       net_unlock();
     }
 
+  /* The local address was changed even if the port could not be bound */
+
+  udp_rehash(conn);
   return ret;
 }
 
@@ -1000,6 +1399,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        */
 
       conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_rehash(conn);
     }
 
   /* Is there a remote port (rport)? */
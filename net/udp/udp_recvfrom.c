@@ -167,6 +167,17 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead
+ *
+ * Description:
+ *   Copy the first datagram of the read-ahead buffer, if any
+ *
+ * Assumptions:
+ *   The caller holds the lock of the connection (see conn_lock()).
+ *
+ ****************************************************************************/
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -630,16 +641,16 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
   udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  The read-ahead buffer is
+   * protected by the lock of the connection, so that receiving datagrams
+   * that are already buffered does not take the network lock.
+   */
 
+  conn_lock(&conn->sconn);
   udp_readahead(&state);
+  conn_unlock(&conn->sconn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -675,6 +686,21 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   else if (state.ir_recvlen <= 0)
     {
+      /* Lock the network so that nothing happens until we are ready.  A
+       * datagram may have been buffered since we checked.
+       */
+
+      net_lock();
+      conn_lock(&conn->sconn);
+      udp_readahead(&state);
+      conn_unlock(&conn->sconn);
+
+      ret = state.ir_recvlen;
+      if (ret > 0)
+        {
+          goto out;
+        }
+
       /* Get the device that will handle the packet transfers.  This may be
        * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
        * NETDEV_DOWN notifications will be received.
@@ -714,9 +740,11 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
         {
           ret = -EBUSY;
         }
+
+out:
+      net_unlock();
     }
 
-  net_unlock();
   udp_recvfrom_uninitialize(&state);
   return ret;
 }
@@ -263,6 +263,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        */
 
       conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_rehash(conn);
     }
 
   /* Get the device that will handle the remote packet transfers.  This
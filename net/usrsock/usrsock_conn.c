@@ -118,6 +118,8 @@ FAR struct usrsock_conn_s *usrsock_alloc(void)
       conn->usockid = -1;
       conn->state = USRSOCK_CONN_STATE_UNINITIALIZED;
 
+      nxrmutex_init(&conn->sconn.s_lock);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_usrsock_connections);
@@ -147,6 +149,7 @@ void usrsock_free(FAR struct usrsock_conn_s *conn)
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_usrsock_connections);
+  nxrmutex_destroy(&conn->sconn.s_lock);
 
   /* Reset structure */
 
@@ -25,71 +25,263 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/nuttx.h>
+
 #include "utils/utils.h"
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* Position of a single byte within a 16-bit word loaded in host order.
+ * BYTE0 is the byte at the lower (even) address, BYTE1 the one at the
+ * higher (odd) address.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b) ((uint32_t)(b) << 8)
+#  define CHKSUM_BYTE1(b) ((uint32_t)(b))
+#else
+#  define CHKSUM_BYTE0(b) ((uint32_t)(b))
+#  define CHKSUM_BYTE1(b) ((uint32_t)(b) << 8)
+#endif
+
+#define CHKSUM_SWAP(v)    ((uint16_t)((v) << 8 | (v) >> 8))
+
 /****************************************************************************
- * Name: chksum
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_add
  *
  * Description:
- *   Calculate the raw change sum over the memory region described by
- *   data and len.
+ *   Add two 16-bit values in ones-complement arithmetic.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_add(uint16_t sum, uint16_t val)
+{
+  sum += val;
+  return sum < val ? sum + 1 : sum;
+}
+
+/****************************************************************************
+ * Name: chksum_core
+ *
+ * Description:
+ *   Sum the memory region described by src and len a word at a time,
+ *   optionally copying it to dst on the way.  The 32-bit words are loaded
+ *   in host order into a 64-bit accumulator, so no carry has to be handled
+ *   inside the loop; the ones-complement sum does not depend on the byte
+ *   order, which is fixed up once when folding the result.
  *
  * Input Parameters:
- *   sum  - Partial calculations carried over from a previous call to
- *          chksum().  This should be zero on the first time that check
- *          sum is called.
- *   data - Beginning of the data to include in the checksum.
+ *   dst  - Where to copy the data to, or NULL to only sum it.
+ *   src  - Beginning of the data to include in the checksum.
  *   len  - Length of the data to include in the checksum.
  *
  * Returned Value:
- *   The updated checksum value.
+ *   The raw sum in the same representation as chksum().
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+static inline uint16_t
+chksum_core(FAR uint8_t *dst, FAR const uint8_t *src, size_t len)
+  always_inline_function;
+
+static inline uint16_t
+chksum_core(FAR uint8_t *dst, FAR const uint8_t *src, size_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  FAR const uint32_t *words;
+  uint64_t acc = 0;
+  uint32_t sum;
+  bool odd;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Align the source to a 32-bit boundary.  Starting at an odd address
+   * shifts every byte to the other half of the words, which is undone by
+   * swapping the folded result.
+   */
+
+  odd = ((uintptr_t)src & 1) != 0;
+  if (odd)
+    {
+      acc = CHKSUM_BYTE1(*src);
+      if (dst != NULL)
+        {
+          *dst++ = *src;
+        }
 
-  dataptr = data;
-  last_byte = data + len - 1;
+      src++;
+      len--;
+    }
 
-  while (dataptr < last_byte)
+  if (len >= 2 && ((uintptr_t)src & 2) != 0)
     {
-      /* At least two more bytes */
+      uint16_t half = *(FAR const uint16_t *)src;
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
+      acc += half;
+      if (dst != NULL)
         {
-          sum++; /* carry */
+          memcpy(dst, &half, 2);
+          dst += 2;
         }
 
-      dataptr += 2;
+      src += 2;
+      len -= 2;
     }
 
-  if (dataptr == last_byte)
+  words = (FAR const uint32_t *)src;
+
+  while (len >= 32)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      uint32_t w0 = words[0];
+      uint32_t w1 = words[1];
+      uint32_t w2 = words[2];
+      uint32_t w3 = words[3];
+      uint32_t w4 = words[4];
+      uint32_t w5 = words[5];
+      uint32_t w6 = words[6];
+      uint32_t w7 = words[7];
+
+      acc += (uint64_t)w0 + w1 + w2 + w3;
+      acc += (uint64_t)w4 + w5 + w6 + w7;
+
+      if (dst != NULL)
         {
-          sum++; /* carry */
+          memcpy(dst, words, 32);
+          dst += 32;
         }
+
+      words += 8;
+      len   -= 32;
     }
 
-  /* Return sum in host byte order. */
+  while (len >= 4)
+    {
+      uint32_t w = *words++;
 
-  return sum;
+      acc += w;
+      if (dst != NULL)
+        {
+          memcpy(dst, &w, 4);
+          dst += 4;
+        }
+
+      len -= 4;
+    }
+
+  src = (FAR const uint8_t *)words;
+
+  if (len >= 2)
+    {
+      uint16_t half = *(FAR const uint16_t *)src;
+
+      acc += half;
+      if (dst != NULL)
+        {
+          memcpy(dst, &half, 2);
+          dst += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += CHKSUM_BYTE0(*src);
+      if (dst != NULL)
+        {
+          *dst = *src;
+        }
+    }
+
+  /* Fold the accumulator down to 16 bits */
+
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  sum = (uint32_t)(acc >> 16) + (uint32_t)(acc & 0xffff);
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum = (sum >> 16) + (sum & 0xffff);
+
+  /* Convert the host order sum into the network order representation
+   * used by chksum(), taking the odd start into account.
+   */
+
+#ifdef CONFIG_ENDIAN_BIG
+  return odd ? CHKSUM_SWAP(sum) : sum;
+#else
+  return odd ? sum : CHKSUM_SWAP(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum
+ *
+ * Description:
+ *   Calculate the raw change sum over the memory region described by
+ *   data and len.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+{
+  return chksum_add(sum, chksum_core(NULL, data, len));
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy the memory region described by src and len to dst and calculate
+ *   its raw change sum in the same pass.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   dst  - Destination of the copy, which must not overlap src.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dst,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  return chksum_add(sum, chksum_core(dst, src, len));
+}
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -111,6 +303,8 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 #ifdef CONFIG_MM_IOB
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 {
+  bool odd = false;
+
   /* Skip to the I/O buffer containing the data offset */
 
   while (iob != NULL && offset > iob->io_len)
@@ -120,19 +314,84 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
     }
 
   /* If the link pointer is not empty, loop to walk through all I/O buffer
-   * and accumulate the sum
+   * and accumulate the sum.  A buffer that follows an odd number of bytes
+   * contributes with its bytes swapped.
    */
 
   while (iob != NULL)
     {
-      sum = chksum(sum, iob->io_data + iob->io_offset + offset,
-                   iob->io_len - offset);
-      iob = iob->io_flink;
+      uint16_t len = iob->io_len - offset;
+      uint16_t part = chksum(0, iob->io_data + iob->io_offset + offset,
+                             len);
+
+      sum    = chksum_add(sum, odd ? CHKSUM_SWAP(part) : part);
+      odd   ^= len & 1;
+      iob    = iob->io_flink;
       offset = 0;
     }
 
   return sum;
 }
+
+/****************************************************************************
+ * Name: chksum_iob_copyin
+ *
+ * Description:
+ *   Copy data into an iob chain like iob_trycopyin() and accumulate its
+ *   raw change sum in the same pass.  The data is summed as part of a
+ *   checksum that starts at an even offset of the chain, so consecutive
+ *   calls may append to the same sum at any offset.
+ *
+ * Input Parameters:
+ *   iob    - The iob chain to copy into, grown as needed.
+ *   src    - The data to copy.
+ *   len    - Length of the data.
+ *   offset - Offset in the iob chain to copy the data to.
+ *   sum    - The checksum to update.
+ *
+ * Returned Value:
+ *   The number of bytes copied on success, a negated errno value if the
+ *   chain could not be grown.
+ *
+ ****************************************************************************/
+
+int chksum_iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, unsigned int offset,
+                      FAR uint16_t *sum)
+{
+  unsigned int remain = len;
+  unsigned int pos = offset;
+
+  if (iob->io_pktlen < offset + len &&
+      iob_update_pktlen(iob, offset + len, false) < offset + len)
+    {
+      return -ENOMEM;
+    }
+
+  /* Skip to the I/O buffer containing the data offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && remain > 0)
+    {
+      unsigned int ncopy = MIN(remain, iob->io_len - offset);
+      uint16_t part = chksum_core(iob->io_data + iob->io_offset + offset,
+                                  src, ncopy);
+
+      *sum    = chksum_add(*sum, (pos & 1) ? CHKSUM_SWAP(part) : part);
+      src    += ncopy;
+      pos    += ncopy;
+      remain -= ncopy;
+      iob     = iob->io_flink;
+      offset  = 0;
+    }
+
+  return len;
+}
 #endif /* CONFIG_MM_IOB */
 
 /****************************************************************************
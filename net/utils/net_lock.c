@@ -37,6 +37,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/rwsem.h>
 
 #include "utils/utils.h"
 
@@ -52,6 +53,10 @@
 
 static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
 
+/* Protects the routing, ARP and neighbor tables */
+
+static rw_semaphore_t g_nettable_lock = RWSEM_INITIALIZER;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -209,6 +214,84 @@ int net_restorelock(unsigned int count)
   return nxrmutex_restorelock(&g_netlock, count);
 }
 
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of one connection
+ *
+ ****************************************************************************/
+
+int conn_lock(FAR struct socket_conn_s *sconn)
+{
+  return nxrmutex_lock(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of one connection
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_unlock(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: net_table_rdlock
+ *
+ * Description:
+ *   Lock the routing, ARP and neighbor tables for reading
+ *
+ ****************************************************************************/
+
+void net_table_rdlock(void)
+{
+  down_read(&g_nettable_lock);
+}
+
+/****************************************************************************
+ * Name: net_table_rdunlock
+ *
+ * Description:
+ *   Release a read lock of the routing, ARP and neighbor tables
+ *
+ ****************************************************************************/
+
+void net_table_rdunlock(void)
+{
+  up_read(&g_nettable_lock);
+}
+
+/****************************************************************************
+ * Name: net_table_wrlock
+ *
+ * Description:
+ *   Lock the routing, ARP and neighbor tables for writing
+ *
+ ****************************************************************************/
+
+void net_table_wrlock(void)
+{
+  down_write(&g_nettable_lock);
+}
+
+/****************************************************************************
+ * Name: net_table_wrunlock
+ *
+ * Description:
+ *   Release the write lock of the routing, ARP and neighbor tables
+ *
+ ****************************************************************************/
+
+void net_table_wrunlock(void)
+{
+  up_write(&g_nettable_lock);
+}
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
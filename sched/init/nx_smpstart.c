@@ -78,6 +78,10 @@ void nx_idle_trampoline(void)
 
   for (; ; )
     {
+      /* Pull waiting tasks that this CPU may run */
+
+      nxsched_balance();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
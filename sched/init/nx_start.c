@@ -176,6 +176,12 @@ volatile pid_t g_lastpid;
 FAR struct tcb_s **g_pidhash;
 volatile int g_npidhash;
 
+/* Protects g_pidhash and g_npidhash for nxsched_get_tcb().  The writers
+ * also hold the critical section, so that they exclude each other.
+ */
+
+rwlock_t g_pidhash_lock = RW_SP_UNLOCKED;
+
 /* This is a table of task lists.  This table is indexed by the task state
  * enumeration type (tstate_t) and provides a pointer to the associated
  * static task list (if there is one) as well as a set of attribute flags
@@ -417,7 +423,7 @@ void nx_start(void)
 #else
       tasklist = TLIST_HEAD(&g_idletcb[i].cmn);
 #endif
-      dq_addfirst((FAR dq_entry_t *)&g_idletcb[i], tasklist);
+      nxsched_addfirst_prioritized(&g_idletcb[i].cmn, tasklist);
 
       /* Mark the idle task as the running task */
 
@@ -707,6 +713,10 @@ void nx_start(void)
 #ifndef CONFIG_DISABLE_IDLE_LOOP
   for (; ; )
     {
+      /* Pull waiting tasks that this CPU may run */
+
+      nxsched_balance();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <assert.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/init.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
@@ -110,7 +111,12 @@ static bool irq_waitlock(int cpu)
 {
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   FAR struct tcb_s *tcb = current_task(cpu);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+  clock_t start = 0;
+#endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock(tcb, &g_cpu_irqlock, NOTE_SPINLOCK_LOCK);
@@ -122,6 +128,15 @@ static bool irq_waitlock(int cpu)
 
   while (!spin_trylock_wo_note(&g_cpu_irqlock))
     {
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* The lock is contended, start measuring the time that we wait */
+
+      if (start == 0)
+        {
+          start = perf_gettime();
+        }
+#endif
+
       /* Is a pause request pending? */
 
       if (up_cpu_pausereq(cpu))
@@ -130,6 +145,10 @@ static bool irq_waitlock(int cpu)
            * Abort the wait and return false.
            */
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+          nxsched_critmon_wait(cpu, perf_gettime() - start);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
           /* Notify that we have aborted the wait for the spinlock */
 
@@ -140,6 +159,13 @@ static bool irq_waitlock(int cpu)
         }
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+  if (start != 0)
+    {
+      nxsched_critmon_wait(cpu, perf_gettime() - start);
+    }
+#endif
+
   /* We have g_cpu_irqlock! */
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
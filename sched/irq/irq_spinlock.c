@@ -220,6 +220,63 @@ void spin_unlock_irqrestore_wo_note(spinlock_t *lock, irqstate_t flags)
   up_irq_restore(flags);
 }
 
+#ifdef CONFIG_MCS_SPINLOCK
+
+/****************************************************************************
+ * Name: mcs_lock_irqsave
+ *
+ * Description:
+ *   Disable local interrupts and take the queued spinlock.  Interrupts stay
+ *   disabled while waiting so that the node cannot be reused by an
+ *   interrupt handler on this CPU before the lock is handed over.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to mcs_lock_irqsave(lock, node);
+ *
+ ****************************************************************************/
+
+irqstate_t mcs_lock_irqsave(FAR volatile mcslock_t *lock,
+                            FAR struct mcs_node_s *node)
+{
+  irqstate_t ret;
+  ret = up_irq_save();
+
+  mcs_lock(lock, node);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mcs_unlock_irqrestore
+ *
+ * Description:
+ *   Release the queued spinlock and restore the interrupt state as it was
+ *   prior to the previous call to mcs_lock_irqsave(lock, node).
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   node  - The node passed to mcs_lock_irqsave().
+ *   flags - The architecture-specific value that represents the state of
+ *           the interrupts prior to the call to mcs_lock_irqsave();
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mcs_unlock_irqrestore(FAR volatile mcslock_t *lock,
+                           FAR struct mcs_node_s *node, irqstate_t flags)
+{
+  mcs_unlock(lock, node);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_MCS_SPINLOCK */
+
 #ifdef CONFIG_RW_SPINLOCK
 
 /****************************************************************************
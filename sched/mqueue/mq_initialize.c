@@ -47,6 +47,10 @@ struct list_node g_msgfree = LIST_INITIAL_VALUE(g_msgfree);
 
 struct list_node g_msgfreeirq = LIST_INITIAL_VALUE(g_msgfreeirq);
 
+/* Protects the two lists above */
+
+spinlock_t g_msgfreelock = SP_UNLOCKED;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
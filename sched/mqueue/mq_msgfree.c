@@ -54,6 +54,8 @@
 
 void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 {
+  irqstate_t flags;
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
@@ -61,10 +63,12 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
   if (mqmsg->type == MQ_ALLOC_FIXED)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
+      flags = spin_lock_irqsave(&g_msgfreelock);
       list_add_tail(&g_msgfree, &mqmsg->node);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -74,10 +78,12 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
   else if (mqmsg->type == MQ_ALLOC_IRQ)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
+      flags = spin_lock_irqsave(&g_msgfreelock);
       list_add_tail(&g_msgfreeirq, &mqmsg->node);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
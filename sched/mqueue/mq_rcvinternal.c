@@ -109,8 +109,9 @@ int nxmq_verify_receive(FAR struct file *mq, FAR char *msg, size_t msglen)
  * Description:
  *   This is internal, common logic shared by both [nx]mq_receive and
  *   [nx]mq_timedreceive.  This function waits for a message to be received
- *   on the specified message queue, removes the message from the queue, and
- *   returns it.
+ *   on the specified message queue, removes the message from the queue,
+ *   notifies any threads that were waiting for the message queue to become
+ *   non-full, and returns it.
  *
  * Input Parameters:
  *   msgq   - Message queue descriptor
@@ -136,6 +137,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
 {
   FAR struct mqueue_msg_s *newmsg;
   FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *btcb;
   bool switch_needed;
 
   DEBUGASSERT(rcvmsg != NULL);
@@ -233,6 +235,48 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
         }
     }
 
+  /* Check if any tasks are waiting for the MQ not full event. */
+
+  if (msgq->cmn.nwaitnotfull > 0)
+    {
+      rtcb = this_task();
+
+      /* Find the highest priority task that is waiting for
+       * this queue to be not-full in waitfornotfull list.
+       * This must be performed in a critical section because
+       * messages can be sent from interrupt handlers.
+       */
+
+      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNFLIST(msgq->cmn));
+
+      /* If one was found, unblock it.  NOTE:  There is a race
+       * condition here:  the queue might be full again by the
+       * time the task is unblocked
+       */
+
+      DEBUGASSERT(btcb != NULL);
+
+      if (WDOG_ISACTIVE(&btcb->waitdog))
+        {
+          wd_cancel(&btcb->waitdog);
+        }
+
+      msgq->cmn.nwaitnotfull--;
+
+      /* Indicate that the wait is over. */
+
+      btcb->waitobj = NULL;
+
+      /* Add the task to ready-to-run task list and
+       * perform the context switch if one is needed
+       */
+
+      if (nxsched_add_readytorun(btcb))
+        {
+          up_switch_context(btcb, rtcb);
+        }
+    }
+
   *rcvmsg = newmsg;
   return OK;
 }
@@ -243,13 +287,11 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
  * Description:
  *   This is internal, common logic shared by both [nx]mq_receive and
  *   [nx]mq_timedreceive.  This function accepts the message obtained by
- *   mq_waitmsg, provides the message content to the user, notifies any
- *   threads that were waiting for the message queue to become non-full,
- *   and disposes of the message structure
+ *   nxmq_wait_receive(), provides the message content to the user, and
+ *   disposes of the message structure.
  *
  * Input Parameters:
- *   msgq    - Message queue descriptor
- *   mqmsg   - The message obtained by mq_waitmsg()
+ *   mqmsg   - The message obtained by nxmq_wait_receive()
  *   ubuffer - The address of the user provided buffer to receive the message
  *   prio    - The user-provided location to return the message priority.
  *
@@ -262,15 +304,14 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
  *   using nxmq_verify_receive.
  * - The user buffer, ubuffer, is known to be large enough to accept the
  *   largest message that an be sent on this message queue
- * - Pre-emption should be disabled throughout this call.
+ * - The message is owned by the caller, so this function does not need to
+ *   be called from within a critical section.
  *
  ****************************************************************************/
 
-ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
-                        FAR struct mqueue_msg_s *mqmsg,
+ssize_t nxmq_do_receive(FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio)
 {
-  FAR struct tcb_s *btcb;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
@@ -292,48 +333,6 @@ ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
 
   nxmq_free_msg(mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
-
-  if (msgq->cmn.nwaitnotfull > 0)
-    {
-      FAR struct tcb_s *rtcb = this_task();
-
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in waitfornotfull list.
-       * This must be performed in a critical section because
-       * messages can be sent from interrupt handlers.
-       */
-
-      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNFLIST(msgq->cmn));
-
-      /* If one was found, unblock it.  NOTE:  There is a race
-       * condition here:  the queue might be full again by the
-       * time the task is unblocked
-       */
-
-      DEBUGASSERT(btcb != NULL);
-
-      if (WDOG_ISACTIVE(&btcb->waitdog))
-        {
-          wd_cancel(&btcb->waitdog);
-        }
-
-      msgq->cmn.nwaitnotfull--;
-
-      /* Indicate that the wait is over. */
-
-      btcb->waitobj = NULL;
-
-      /* Add the task to ready-to-run task list and
-       * perform the context switch if one is needed
-       */
-
-      if (nxsched_add_readytorun(btcb))
-        {
-          up_switch_context(btcb, rtcb);
-        }
-    }
-
   /* Return the length of the message transferred to the user buffer */
 
   return rcvmsglen;
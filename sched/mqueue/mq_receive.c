@@ -102,20 +102,23 @@ ssize_t file_mq_receive(FAR struct file *mq, FAR char *msg, size_t msglen,
 
   ret = nxmq_wait_receive(msgq, mq->f_oflags, &mqmsg);
 
+  leave_critical_section(flags);
+
   /* Check if we got a message from the message queue.  We might
    * not have a message if:
    *
    * - The message queue is empty and O_NONBLOCK is set in the mq
    * - The wait was interrupted by a signal
+   *
+   * The message is no longer in the message queue, so it can be copied
+   * to the user buffer outside of the critical section.
    */
 
   if (ret == OK)
     {
-      ret = nxmq_do_receive(msgq, mqmsg, msg, prio);
+      ret = nxmq_do_receive(mqmsg, msg, prio);
     }
 
-  leave_critical_section(flags);
-
   return ret;
 }
 
@@ -88,7 +88,22 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
 
   msgq = mq->f_inode->i_private;
 
-  /* Allocate a message structure:
+  /* Allocate a message structure and copy the message into it before
+   * entering the critical section.  If the message queue is full, the
+   * message is held while waiting for space to become available.
+   */
+
+  mqmsg = nxmq_alloc_msg(msg, msglen, prio);
+  if (mqmsg == NULL)
+    {
+      /* Failed to allocate the message. nxmq_alloc_msg() does not set the
+       * errno value.
+       */
+
+      return -ENOMEM;
+    }
+
+  /* Send the message:
    * - Immediately if we are called from an interrupt handler.
    * - Immediately if the message queue is not full, or
    * - After successfully waiting for the message queue to become
@@ -115,15 +130,7 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
 
   if (ret == OK)
     {
-      /* Now allocate the message. */
-
-      mqmsg = nxmq_alloc_msg();
-      DEBUGASSERT(mqmsg != NULL);
-
-      /* Check if the message was successfully allocated */
-
-      /* The allocation was successful (implying that we can also send the
-       * message). Perform the message send.
+      /* Perform the message send.
        *
        * NOTE: There is a race condition here: What if a message is added by
        * interrupt related logic so that queue again becomes non-empty.
@@ -131,11 +138,18 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
        * to be exceeded in that case.
        */
 
-      ret = nxmq_do_send(msgq, mqmsg, msg, msglen, prio);
+      ret = nxmq_do_send(msgq, mqmsg);
     }
 
   leave_critical_section(flags);
 
+  /* Release the message if it could not be sent */
+
+  if (ret < 0)
+    {
+      nxmq_free_msg(mqmsg);
+    }
+
   return ret;
 }
 
@@ -112,8 +112,8 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system and copy the message data into it.  The message will
+ *   be allocated from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -125,61 +125,76 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
+ *   This function does not need to be called from within a critical
+ *   section, so the message data is copied while the other CPUs may use
+ *   the message queue.
+ *
  * Input Parameters:
- *   None
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
  *
  * Returned Value:
- *   A reference to the allocated msg structure.  On a failure to allocate,
- *   this function PANICs.
+ *   A reference to the allocated msg structure, or NULL on a failure to
+ *   allocate.
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR const char *msg,
+                                        size_t msglen, unsigned int prio)
 {
-  FAR struct list_node *mqmsg;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
 
   /* Try to get the message from the generally available free list. */
 
-  mqmsg = list_remove_head(&g_msgfree);
-  if (mqmsg == NULL)
+  flags = spin_lock_irqsave(&g_msgfreelock);
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfree);
+  if (mqmsg == NULL && up_interrupt_context())
     {
-      /* If we were called from an interrupt handler, then try to get the
-       * message from generally available list of messages. If this fails,
-       * then try the list of messages reserved for interrupt handlers
+      /* If we were called from an interrupt handler, then try the free
+       * list reserved for interrupt handlers.
        */
 
+      mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&g_msgfreeirq);
+    }
+
+  spin_unlock_irqrestore(&g_msgfreelock, flags);
+
+  if (mqmsg == NULL)
+    {
+      /* Interrupt handlers cannot allocate memory */
+
       if (up_interrupt_context())
         {
-          /* Try the free list reserved for interrupt handlers */
-
-          mqmsg = list_remove_head(&g_msgfreeirq);
+          return NULL;
         }
 
-      /* We were not called from an interrupt handler. */
+      /* If we cannot a message from the free list, then we will have to
+       * allocate one.
+       */
 
-      else
+      mqmsg = kmm_malloc((sizeof (struct mqueue_msg_s)));
+      if (mqmsg == NULL)
         {
-          /* If we cannot a message from the free list, then we will have to
-           * allocate one.
-           */
+          return NULL;
+        }
 
-          mqmsg = (FAR struct list_node *)
-            kmm_malloc((sizeof (struct mqueue_msg_s)));
+      /* Remember that this message was dynamically allocated. */
 
-          /* Check if we allocated the message */
+      mqmsg->type = MQ_ALLOC_DYN;
+    }
 
-          if (mqmsg != NULL)
-            {
-              /* Yes... remember that this message was dynamically
-               * allocated.
-               */
+  /* Construct the message header info */
 
-              ((FAR struct mqueue_msg_s *)mqmsg)->type = MQ_ALLOC_DYN;
-            }
-        }
-    }
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
 
-  return (FAR struct mqueue_msg_s *)mqmsg;
+  /* Copy the message data into the message */
+
+  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  return mqmsg;
 }
 
 /****************************************************************************
@@ -305,38 +320,30 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags)
  *
  * Description:
  *   This is internal, common logic shared by both [nx]mq_send and
- *   [nx]mq_timesend.  This function adds the specified message (msg) to the
- *   message queue (msgq).  Then it notifies any tasks that were waiting
+ *   [nx]mq_timesend.  This function adds the specified message (mqmsg) to
+ *   the message queue (msgq).  Then it notifies any tasks that were waiting
  *   for message queue notifications setup by mq_notify.  And, finally, it
  *   awakens any tasks that were waiting for the message not empty event.
  *
  * Input Parameters:
  *   msgq   - Message queue descriptor
- *   msg    - Message to send
- *   msglen - The length of the message in bytes
- *   prio   - The priority of the message
+ *   mqmsg  - The message obtained by nxmq_alloc_msg()
  *
  * Returned Value:
  *   This function always returns OK.
  *
+ * Assumptions:
+ * - Executes within a critical section established by the caller.
+ *
  ****************************************************************************/
 
 int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
-                 FAR struct mqueue_msg_s *mqmsg,
-                 FAR const char *msg, size_t msglen, unsigned int prio)
+                 FAR struct mqueue_msg_s *mqmsg)
 {
   FAR struct mqueue_msg_s *prev = NULL;
   FAR struct mqueue_msg_s *next;
   FAR struct tcb_s *btcb;
-
-  /* Construct the message header info */
-
-  mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
-
-  /* Copy the message data into the message */
-
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  unsigned int prio = mqmsg->priority;
 
   /* Insert the new message in the message queue
    * Search the message list to find the location to insert the new
@@ -216,25 +216,28 @@ ssize_t file_mq_timedreceive(FAR struct file *mq, FAR char *msg,
 
   wd_cancel(&rtcb->waitdog);
 
+  /* We can now restore interrupts */
+
+errout_in_critical_section:
+  leave_critical_section(flags);
+
   /* Check if we got a message from the message queue.  We might
    * not have a message if:
    *
    * - The message queue is empty and O_NONBLOCK is set in the mqdes
    * - The wait was interrupted by a signal
    * - The watchdog timeout expired
+   *
+   * The message is no longer in the message queue, so it can be copied
+   * to the user buffer outside of the critical section.
    */
 
   if (ret == OK)
     {
       DEBUGASSERT(mqmsg != NULL);
-      ret = nxmq_do_receive(msgq, mqmsg, msg, prio);
+      ret = nxmq_do_receive(mqmsg, msg, prio);
     }
 
-  /* We can now restore interrupts */
-
-errout_in_critical_section:
-  leave_critical_section(flags);
-
   return ret;
 }
 
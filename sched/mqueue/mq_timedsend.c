@@ -165,23 +165,24 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
-  /* Disable interruption */
-
-  flags = enter_critical_section();
-
-  /* Pre-allocate a message structure */
+  /* Pre-allocate a message structure and copy the message into it before
+   * entering the critical section.
+   */
 
-  mqmsg = nxmq_alloc_msg();
+  mqmsg = nxmq_alloc_msg(msg, msglen, prio);
   if (mqmsg == NULL)
     {
       /* Failed to allocate the message. nxmq_alloc_msg() does not set the
        * errno value.
        */
 
-      ret = -ENOMEM;
-      goto errout_in_critical_section;
+      return -ENOMEM;
     }
 
+  /* Disable interruption */
+
+  flags = enter_critical_section();
+
   /* OpenGroup.org: "Under no circumstance shall the operation fail with a
    * timeout if there is sufficient room in the queue to add the message
    * immediately. The validity of the abstime parameter need not be checked
@@ -212,7 +213,6 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
   if (!abstime || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
     {
       ret = -EINVAL;
-      nxmq_free_msg(mqmsg);
       goto errout_in_critical_section;
     }
 
@@ -239,7 +239,6 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
   if (ret != OK)
     {
       ret = -ret;
-      nxmq_free_msg(mqmsg);
       goto errout_in_critical_section;
     }
 
@@ -262,14 +261,13 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
   if (ret == OK)
     {
       /* If any of the above failed, set the errno.  Otherwise, there should
-       * be space for another message in the message queue.  NOW we can
-       * allocate the message structure.
+       * be space for another message in the message queue.
        *
        * Currently nxmq_do_send() always returns OK.
        */
 
 out_send_message:
-      ret = nxmq_do_send(msgq, mqmsg, msg, msglen, prio);
+      ret = nxmq_do_send(msgq, mqmsg);
     }
 
   /* Exit here with (1) the scheduler locked, (2) a message allocated, (3) a
@@ -279,6 +277,13 @@ out_send_message:
 errout_in_critical_section:
   leave_critical_section(flags);
 
+  /* Release the message if it could not be sent */
+
+  if (ret < 0)
+    {
+      nxmq_free_msg(mqmsg);
+    }
+
   return ret;
 }
 
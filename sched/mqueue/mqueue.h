@@ -36,6 +36,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/spinlock.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -97,6 +98,12 @@ EXTERN struct list_node g_msgfree;
 
 EXTERN struct list_node g_msgfreeirq;
 
+/* Protects g_msgfree and g_msgfreeirq, which are accessed outside of the
+ * critical section.
+ */
+
+EXTERN spinlock_t g_msgfreelock;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -122,8 +129,7 @@ int nxmq_verify_receive(FAR struct file *mq, FAR char *msg, size_t msglen);
 #endif
 int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                       int oflags, FAR struct mqueue_msg_s **rcvmsg);
-ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
-                        FAR struct mqueue_msg_s *mqmsg,
+ssize_t nxmq_do_receive(FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
 
 /* mq_sndinternal.c *********************************************************/
@@ -134,11 +140,11 @@ int nxmq_verify_send(FAR struct file *mq, FAR const char *msg,
 #else
 #  define nxmq_verify_send(mq, msg, msglen, prio) OK
 #endif
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR const char *msg,
+                                        size_t msglen, unsigned int prio);
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags);
 int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
-                 FAR struct mqueue_msg_s *mqmsg,
-                 FAR const char *msg, size_t msglen, unsigned int prio);
+                 FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_recover.c *************************************************************/
 
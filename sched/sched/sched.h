@@ -225,6 +225,7 @@ extern volatile pid_t g_lastpid;
 
 extern FAR struct tcb_s **g_pidhash;
 extern volatile int g_npidhash;
+extern rwlock_t g_pidhash_lock;
 
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -328,6 +329,23 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 bool nxsched_add_readytorun(FAR struct tcb_s *rtrtcb);
 bool nxsched_remove_readytorun(FAR struct tcb_s *rtrtcb, bool merge);
 bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+bool nxsched_readyqueue_next(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                             FAR struct tcb_s **next);
+void nxsched_remove_prioritized(FAR struct tcb_s *tcb,
+                                DSEG dq_queue_t *list);
+void nxsched_addfirst_prioritized(FAR struct tcb_s *tcb,
+                                  DSEG dq_queue_t *list);
+void nxsched_reprioritize_head(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                               int priority);
+#else
+#  define nxsched_remove_prioritized(tcb,list) \
+     dq_rem((FAR dq_entry_t *)(tcb), list)
+#  define nxsched_addfirst_prioritized(tcb,list) \
+     dq_addfirst((FAR dq_entry_t *)(tcb), list)
+#  define nxsched_reprioritize_head(tcb,list,priority) \
+     ((tcb)->sched_priority = (uint8_t)(priority))
+#endif
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state);
 bool nxsched_merge_pending(void);
@@ -395,6 +413,12 @@ int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 #  define nxsched_islocked_tcb(tcb) ((tcb)->lockcount > 0)
 #endif
 
+#ifdef CONFIG_SCHED_BALANCE
+void nxsched_balance(void);
+#else
+#  define nxsched_balance()
+#endif
+
 /* CPU load measurement support */
 
 #if defined(CONFIG_SCHED_CPULOAD_SYSCLK) || \
@@ -411,6 +435,9 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state);
 void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state);
 void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
+#ifdef CONFIG_SMP
+void nxsched_critmon_wait(int cpu, clock_t elapsed);
+#endif
 #endif
 
 /* TCB operations */
@@ -174,6 +174,19 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        */
 
       cpu = nxsched_select_cpu(btcb->affinity);
+
+#ifdef CONFIG_SCHED_BALANCE
+      /* Prefer the CPU that the task last ran on if it is as good as the
+       * selected CPU, its cache may still hold the working set of the task.
+       */
+
+      if (cpu != btcb->cpu && CPU_ISSET(btcb->cpu, &btcb->affinity) &&
+          current_task(btcb->cpu)->sched_priority ==
+          current_task(cpu)->sched_priority)
+        {
+          cpu = btcb->cpu;
+        }
+#endif
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -327,7 +340,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
             {
               /* Remove the task from the assigned task list */
 
-              dq_rem((FAR dq_entry_t *)next, tasklist);
+              nxsched_remove_prioritized(next, tasklist);
 
               /* Add the task to the g_readytorun or to the g_pendingtasks
                * list.  NOTE: That the above operations may cause the
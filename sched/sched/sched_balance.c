@@ -0,0 +1,250 @@
+/****************************************************************************
+ * sched/sched/sched_balance.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_BALANCE
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The time of the last balance by each CPU */
+
+static clock_t g_balance_time[CONFIG_SMP_NCPUS];
+
+/* The task that each CPU found at its last balance.  A task is only pulled
+ * if it is still waiting at the next balance, so that an idle CPU does not
+ * race the CPU that is about to run the task anyway.
+ */
+
+static FAR struct tcb_s *g_balance_candidate[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_balance_readytorun
+ *
+ * Description:
+ *   Return the highest priority task in the g_readytorun list that may run
+ *   on 'cpu'.  Among the tasks of that priority, prefer one that last ran
+ *   on 'cpu' since its cache may still be warm.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_balance_readytorun(int cpu)
+{
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *tcb;
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL;
+       tcb = tcb->flink)
+    {
+      if (best != NULL && tcb->sched_priority < best->sched_priority)
+        {
+          break;
+        }
+
+      if (CPU_ISSET(cpu, &tcb->affinity))
+        {
+          if (best == NULL)
+            {
+              best = tcb;
+            }
+
+          if (tcb->cpu == cpu)
+            {
+              return tcb;
+            }
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: nxsched_balance_assigned
+ *
+ * Description:
+ *   Find the CPU with the most tasks that are ready-to-run, but stuck in
+ *   its g_assignedtasks[] list behind the running task, and that may run on
+ *   'cpu'.  Return the highest priority of these tasks.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_balance_assigned(int cpu)
+{
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *first;
+  FAR struct tcb_s *tcb;
+  int most = 0;
+  int count;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      first = NULL;
+      count = 0;
+
+      /* Skip the running task at the head of the list */
+
+      for (tcb = current_task(i)->flink; tcb != NULL; tcb = tcb->flink)
+        {
+          if ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 &&
+              CPU_ISSET(cpu, &tcb->affinity))
+            {
+              if (first == NULL)
+                {
+                  first = tcb;
+                }
+
+              count++;
+            }
+        }
+
+      if (count > most)
+        {
+          most = count;
+          best = first;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_balance
+ *
+ * Description:
+ *   Called from the IDLE loop of each CPU.  If the CPU is idle while tasks
+ *   that it may run are waiting, pull the best of them:  first from the
+ *   g_readytorun list, then from the g_assignedtasks[] list of the CPU with
+ *   the most waiting tasks.  The tasks running on the other CPUs are never
+ *   moved.
+ *
+ *   This happens, for example, when the affinity mask of a waiting task is
+ *   widened, or when the task was assigned to a CPU that was preempted by
+ *   another CPU right after it was selected.  Otherwise, such tasks wait
+ *   until a running task blocks.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_balance(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  clock_t now;
+  int me;
+
+  /* Do nothing more often than once per interval.  Only this CPU accesses
+   * its own entries, so there is no need for a critical section yet.
+   */
+
+  me  = this_cpu();
+  now = clock_systime_ticks();
+
+  if (now - g_balance_time[me] < CONFIG_SCHED_BALANCE_INTERVAL)
+    {
+      return;
+    }
+
+  g_balance_time[me] = now;
+
+  flags = enter_critical_section();
+
+  /* Pre-emption may have been locked, or the IDLE task may have been
+   * pre-empted, since we checked.
+   */
+
+  rtcb = this_task();
+  if (!is_idle_task(rtcb) || nxsched_islocked_global())
+    {
+      g_balance_candidate[me] = NULL;
+      goto out;
+    }
+
+  tcb = nxsched_balance_readytorun(me);
+  if (tcb == NULL)
+    {
+      tcb = nxsched_balance_assigned(me);
+    }
+
+  /* Wait for one more interval before pulling a task (hysteresis) */
+
+  if (tcb == NULL || tcb != g_balance_candidate[me])
+    {
+      g_balance_candidate[me] = tcb;
+      goto out;
+    }
+
+  g_balance_candidate[me] = NULL;
+
+  /* The task is not running, so removing it causes no context switch.
+   * Adding it back places it on the lowest priority CPU permitted by its
+   * affinity mask, which is this CPU or another idle CPU.
+   */
+
+  nxsched_remove_readytorun(tcb, false);
+  if (nxsched_add_readytorun(tcb))
+    {
+      up_switch_context(this_task(), rtcb);
+    }
+
+out:
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_BALANCE */
@@ -0,0 +1,241 @@
+/****************************************************************************
+ * sched/sched/sched_balance_test.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Benchmark driver.  Like mm/mm_gran/mm_gran_test.c, this is not part of
+ * any build.  It is meant to be built as an application of an SMP
+ * configuration such as sim:smp, once with and once without
+ * CONFIG_SCHED_BALANCE.
+ *
+ * All threads start on CPU0 and their affinity masks are then widened to
+ * all CPUs, leaving the other CPUs idle while the threads wait on CPU0.
+ * The benchmark prints the time until all CPU-bound threads are done
+ * (makespan), and the wake-up latency of periodic threads competing with
+ * them for the CPUs.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NWORKERS   (4 * CONFIG_SMP_NCPUS)  /* CPU-bound threads */
+#define NWAKERS    CONFIG_SMP_NCPUS        /* Periodic threads */
+#define WORK_MS    200                     /* Work of each CPU-bound thread */
+#define PERIOD_US  2000                    /* Period of the periodic threads */
+#define NPERIODS   200
+#define PRIORITY   100
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_latency[NWAKERS * NPERIODS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* Spin for WORK_MS of CPU time, counting only the time that the thread
+ * actually runs.
+ */
+
+static FAR void *worker(FAR void *arg)
+{
+  uint64_t done = 0;
+  uint64_t last = now_us();
+
+  while (done < WORK_MS * 1000)
+    {
+      uint64_t now = now_us();
+
+      if (now - last < 100)
+        {
+          done += now - last;
+        }
+
+      last = now;
+    }
+
+  return NULL;
+}
+
+/* Sleep for one period at a time and record how late each wake-up is */
+
+static FAR void *waker(FAR void *arg)
+{
+  FAR uint32_t *latency = arg;
+  uint64_t next = now_us();
+  int i;
+
+  for (i = 0; i < NPERIODS; i++)
+    {
+      uint64_t now;
+
+      next += PERIOD_US;
+      now   = now_us();
+      if (next > now)
+        {
+          usleep(next - now);
+        }
+
+      latency[i] = now_us() - next;
+    }
+
+  return NULL;
+}
+
+static void create(FAR pthread_t *thread, pthread_startroutine_t entry,
+                   FAR void *arg)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(0, &cpuset);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedpolicy(&attr, SCHED_RR);
+  param.sched_priority = PRIORITY;
+  pthread_attr_setschedparam(&attr, &param);
+  pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+  pthread_create(thread, &attr, entry, arg);
+  pthread_attr_destroy(&attr);
+}
+
+static void widen(pthread_t thread)
+{
+  cpu_set_t cpuset;
+  int i;
+
+  CPU_ZERO(&cpuset);
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      CPU_SET(i, &cpuset);
+    }
+
+  pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ *
+ * Description:
+ *   A simple benchmark for the SMP load balancer
+ *
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  pthread_t workers[NWORKERS];
+  pthread_t wakers[NWAKERS];
+  struct sched_param param;
+  uint64_t start;
+  uint64_t makespan;
+  int n = NWAKERS * NPERIODS;
+  int i;
+
+  /* Run above the threads so that they are all created before they run */
+
+  param.sched_priority = PRIORITY + 1;
+  pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+  for (i = 0; i < NWORKERS; i++)
+    {
+      create(&workers[i], worker, NULL);
+    }
+
+  for (i = 0; i < NWAKERS; i++)
+    {
+      create(&wakers[i], waker, &g_latency[i * NPERIODS]);
+    }
+
+  start = now_us();
+
+  for (i = 0; i < NWORKERS; i++)
+    {
+      widen(workers[i]);
+    }
+
+  for (i = 0; i < NWAKERS; i++)
+    {
+      widen(wakers[i]);
+    }
+
+  for (i = 0; i < NWORKERS; i++)
+    {
+      pthread_join(workers[i], NULL);
+    }
+
+  makespan = now_us() - start;
+
+  for (i = 0; i < NWAKERS; i++)
+    {
+      pthread_join(wakers[i], NULL);
+    }
+
+  qsort(g_latency, n, sizeof(g_latency[0]), compare);
+
+  printf("%d CPUs, %d workers of %d ms: makespan %llu ms "
+         "(ideal %d ms)\n",
+         CONFIG_SMP_NCPUS, NWORKERS, WORK_MS,
+         (unsigned long long)(makespan / 1000),
+         NWORKERS * WORK_MS / CONFIG_SMP_NCPUS);
+  printf("wake-up latency: p50 %lu us, p99 %lu us, max %lu us\n",
+         (unsigned long)g_latency[n / 2],
+         (unsigned long)g_latency[n * 99 / 100],
+         (unsigned long)g_latency[n - 1]);
+
+  return EXIT_SUCCESS;
+}
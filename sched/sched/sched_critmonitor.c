@@ -116,6 +116,13 @@ static clock_t g_crit_start[CONFIG_SMP_NCPUS];
 clock_t g_premp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SMP
+/* Maximum and total time spent waiting for the g_cpu_irqlock. */
+
+clock_t g_crit_wait_max[CONFIG_SMP_NCPUS];
+clock_t g_crit_wait_total[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -216,6 +223,29 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
     }
 }
 
+/****************************************************************************
+ * Name: nxsched_critmon_wait
+ *
+ * Description:
+ *   Called when a CPU had to wait for the g_cpu_irqlock before entering the
+ *   critical section.
+ *
+ * Assumptions:
+ *   - Called with interrupts disabled on this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void nxsched_critmon_wait(int cpu, clock_t elapsed)
+{
+  g_crit_wait_total[cpu] += elapsed;
+  if (elapsed > g_crit_wait_max[cpu])
+    {
+      g_crit_wait_max[cpu] = elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_resume_critmon
  *
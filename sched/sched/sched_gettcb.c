@@ -41,9 +41,10 @@
  *   Given a task ID, this function will return the a pointer to the
  *   corresponding TCB (or NULL if there is no such task ID).
  *
- *   NOTE:  This function holds a critical section while examining TCB data
- *   data structures but releases that critical section before returning.
- *   When it is released, the TCB may become unstable.  If the caller
+ *   NOTE:  This function only takes the read side of g_pidhash_lock while
+ *   examining the g_pidhash[] table, so that lookups on several CPUs may
+ *   proceed in parallel, and releases it before returning.  When it is
+ *   released, the TCB may become unstable.  If the caller
  *   requires absolute stability while using the TCB, then the caller
  *   should establish the critical section BEFORE calling this function and
  *   hold that critical section as long as necessary.
@@ -56,7 +57,7 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid)
   irqstate_t flags;
   int hash_ndx;
 
-  flags = spin_lock_irqsave_wo_note(NULL);
+  flags = read_lock_irqsave(&g_pidhash_lock);
 
   /* Verify whether g_pidhash hash table has already been allocated and
    * whether the PID is within range.
@@ -84,7 +85,7 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid)
         }
     }
 
-  spin_unlock_irqrestore_wo_note(NULL, flags);
+  read_unlock_irqrestore(&g_pidhash_lock, flags);
 
   /* Return the TCB. */
 
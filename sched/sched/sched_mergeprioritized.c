@@ -64,13 +64,28 @@
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state)
 {
+#ifndef CONFIG_SCHED_READYQUEUE_BITMAP
   dq_queue_t clone;
   FAR struct tcb_s *tcb1;
   FAR struct tcb_s *tcb2;
+#endif
   FAR struct tcb_s *tmp;
 
   DEBUGASSERT(list1 != NULL && list2 != NULL);
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+  /* The ready-to-run and the pending task lists are indexed by priority.
+   * Move the TCBs one at a time so that the indexes follow them, each TCB
+   * finding its place in list2 without a search.
+   */
+
+  while ((tmp = (FAR struct tcb_s *)dq_peek(list1)) != NULL)
+    {
+      nxsched_remove_prioritized(tmp, list1);
+      tmp->task_state = task_state;
+      nxsched_add_prioritized(tmp, list2);
+    }
+#else
   /* Get a private copy of list1, clearing list1.  We do this early so that
    * we can be assured that the list is stationary before we start any
    * operations on it.
@@ -157,4 +172,5 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
         }
     }
   while (tcb1 != NULL);
+#endif
 }
@@ -0,0 +1,341 @@
+/****************************************************************************
+ * sched/sched/sched_readyqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define READYQUEUE_NPRIO   (SCHED_PRIORITY_MAX + 1)
+#define READYQUEUE_NWORDS  ((READYQUEUE_NPRIO + 31) >> 5)
+
+/* g_readytorun, g_pendingtasks and one g_assignedtasks[] list per CPU */
+
+#ifdef CONFIG_SMP
+#  define READYQUEUE_NLISTS (2 + CONFIG_SMP_NCPUS)
+#else
+#  define READYQUEUE_NLISTS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The TCBs of each priority are a FIFO segment of the prioritized list.
+ * The index of a list remembers the last TCB of every segment and has a
+ * bit set for every priority that has a segment, so that the place of a
+ * new TCB is found without walking the list.
+ */
+
+struct readyqueue_s
+{
+  uint32_t summary;                         /* Bit n: bitmap[n] != 0 */
+  uint32_t bitmap[READYQUEUE_NWORDS];       /* Bit n: tail[n] != NULL */
+  FAR struct tcb_s *tail[READYQUEUE_NPRIO]; /* Last TCB of each priority */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct readyqueue_s g_readyqueue[READYQUEUE_NLISTS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_readyqueue
+ *
+ * Description:
+ *   Return the index of a ready-to-run or the pending task list, or NULL
+ *   for any other list.
+ *
+ ****************************************************************************/
+
+static FAR struct readyqueue_s *nxsched_readyqueue(DSEG dq_queue_t *list)
+{
+  if (list == &g_readytorun)
+    {
+      return &g_readyqueue[0];
+    }
+  else if (list == &g_pendingtasks)
+    {
+      return &g_readyqueue[1];
+    }
+#ifdef CONFIG_SMP
+  else if (list >= g_assignedtasks &&
+           list < &g_assignedtasks[CONFIG_SMP_NCPUS])
+    {
+      return &g_readyqueue[2 + (list - g_assignedtasks)];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_readyqueue_lowest
+ *
+ * Description:
+ *   Return the lowest priority with TCBs in the list that is higher than
+ *   or equal to 'priority', or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int nxsched_readyqueue_lowest(FAR struct readyqueue_s *rq,
+                                     int priority)
+{
+  uint32_t bits;
+  int word = priority >> 5;
+
+  bits = rq->bitmap[word] & (UINT32_MAX << (priority & 31));
+  if (bits == 0)
+    {
+      bits = rq->summary & ~((UINT32_C(2) << word) - 1);
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      word = ffs(bits) - 1;
+      bits = rq->bitmap[word];
+    }
+
+  return (word << 5) + ffs(bits) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_readyqueue_set / nxsched_readyqueue_clear
+ *
+ * Description:
+ *   Mark a priority as present in or absent from the list.
+ *
+ ****************************************************************************/
+
+static void nxsched_readyqueue_set(FAR struct readyqueue_s *rq,
+                                   int priority)
+{
+  int word = priority >> 5;
+
+  rq->bitmap[word] |= UINT32_C(1) << (priority & 31);
+  rq->summary      |= UINT32_C(1) << word;
+}
+
+static void nxsched_readyqueue_clear(FAR struct readyqueue_s *rq,
+                                     int priority)
+{
+  int word = priority >> 5;
+
+  rq->tail[priority] = NULL;
+  rq->bitmap[word]  &= ~(UINT32_C(1) << (priority & 31));
+  if (rq->bitmap[word] == 0)
+    {
+      rq->summary &= ~(UINT32_C(1) << word);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_readyqueue_detach
+ *
+ * Description:
+ *   Remove a TCB, still linked in its list, from the index of the list.
+ *
+ ****************************************************************************/
+
+static void nxsched_readyqueue_detach(FAR struct readyqueue_s *rq,
+                                      FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev = tcb->blink;
+  int priority = tcb->sched_priority;
+
+  if (rq->tail[priority] == tcb)
+    {
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          rq->tail[priority] = prev;
+        }
+      else
+        {
+          nxsched_readyqueue_clear(rq, priority);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_readyqueue_next
+ *
+ * Description:
+ *   Find the place of a TCB in a ready-to-run or the pending task list in
+ *   constant time and add the TCB to the index of the list.  The TCB goes
+ *   after the last TCB with the lowest priority that is higher than or
+ *   equal to the priority of the TCB.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB to be added to the list
+ *   list - The prioritized list
+ *   next - The location to return the TCB that 'tcb' goes before, or NULL
+ *          if 'tcb' goes at the end of the list.
+ *
+ * Returned Value:
+ *   false if the list is not indexed and must be searched instead.
+ *
+ ****************************************************************************/
+
+bool nxsched_readyqueue_next(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                             FAR struct tcb_s **next)
+{
+  FAR struct readyqueue_s *rq = nxsched_readyqueue(list);
+  int priority = tcb->sched_priority;
+  int lowest;
+
+  if (rq == NULL)
+    {
+      return false;
+    }
+
+  lowest = nxsched_readyqueue_lowest(rq, priority);
+  if (lowest < 0)
+    {
+      *next = (FAR struct tcb_s *)list->head;
+    }
+  else
+    {
+      *next = rq->tail[lowest]->flink;
+    }
+
+  rq->tail[priority] = tcb;
+  nxsched_readyqueue_set(rq, priority);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_prioritized
+ *
+ * Description:
+ *   Remove a TCB from a prioritized list, keeping the index of the list
+ *   up to date.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB to be removed
+ *   list - The list that holds the TCB
+ *
+ ****************************************************************************/
+
+void nxsched_remove_prioritized(FAR struct tcb_s *tcb,
+                                DSEG dq_queue_t *list)
+{
+  FAR struct readyqueue_s *rq = nxsched_readyqueue(list);
+
+  if (rq != NULL)
+    {
+      nxsched_readyqueue_detach(rq, tcb);
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+/****************************************************************************
+ * Name: nxsched_addfirst_prioritized
+ *
+ * Description:
+ *   Add a TCB at the head of a prioritized list, ahead of the TCBs of the
+ *   same priority.  The TCB must have the highest priority of the list.
+ *
+ * Input Parameters:
+ *   tcb  - The TCB to be added
+ *   list - The prioritized list
+ *
+ ****************************************************************************/
+
+void nxsched_addfirst_prioritized(FAR struct tcb_s *tcb,
+                                  DSEG dq_queue_t *list)
+{
+  FAR struct readyqueue_s *rq = nxsched_readyqueue(list);
+  int priority = tcb->sched_priority;
+
+  DEBUGASSERT(list->head == NULL ||
+              ((FAR struct tcb_s *)list->head)->sched_priority <= priority);
+
+  dq_addfirst((FAR dq_entry_t *)tcb, list);
+
+  if (rq != NULL && rq->tail[priority] == NULL)
+    {
+      rq->tail[priority] = tcb;
+      nxsched_readyqueue_set(rq, priority);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_reprioritize_head
+ *
+ * Description:
+ *   Change the priority of the TCB at the head of a prioritized list
+ *   without moving it.  The new priority must not be lower than the
+ *   priority of the TCB that follows it.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB at the head of the list
+ *   list     - The prioritized list
+ *   priority - The new priority of the TCB
+ *
+ ****************************************************************************/
+
+void nxsched_reprioritize_head(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                               int priority)
+{
+  FAR struct readyqueue_s *rq = nxsched_readyqueue(list);
+
+  DEBUGASSERT(tcb->blink == NULL);
+
+  if (rq != NULL)
+    {
+      nxsched_readyqueue_detach(rq, tcb);
+      if (rq->tail[priority] == NULL)
+        {
+          rq->tail[priority] = tcb;
+          nxsched_readyqueue_set(rq, priority);
+        }
+    }
+
+  tcb->sched_priority = (uint8_t)priority;
+}
+
+#endif /* CONFIG_SCHED_READYQUEUE_BITMAP */
@@ -50,6 +50,7 @@ static void nxsched_releasepid(pid_t pid)
 {
   irqstate_t flags = enter_critical_section();
   int hash_ndx = PIDHASH(pid);
+  irqstate_t lock;
 
 #ifndef CONFIG_SCHED_CPULOAD_NONE
   /* Decrement the total CPU load count held by this thread from the
@@ -59,12 +60,11 @@ static void nxsched_releasepid(pid_t pid)
   g_cpuload_total -= g_pidhash[hash_ndx]->ticks;
 #endif
 
-  /* Make any pid associated with this hash available.  Note:
-   * no special precautions need be taken here because the
-   * following action is atomic
-   */
+  /* Make any pid associated with this hash available */
 
+  lock = write_lock_irqsave(&g_pidhash_lock);
   g_pidhash[hash_ndx] = NULL;
+  write_unlock_irqrestore(&g_pidhash_lock, lock);
 
   leave_critical_section(flags);
 }
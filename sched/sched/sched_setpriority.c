@@ -35,6 +35,18 @@
 #include "irq/irq.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The list that holds a running task */
+
+#ifdef CONFIG_SMP
+#  define RUNNING_LIST(t) TLIST_HEAD(t, (t)->cpu)
+#else
+#  define RUNNING_LIST(t) TLIST_HEAD(t)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -167,7 +179,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_reprioritize_head(tcb, RUNNING_LIST(tcb), sched_priority);
         }
       else
         {
@@ -186,7 +198,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_reprioritize_head(tcb, RUNNING_LIST(tcb), sched_priority);
     }
 }
 
@@ -321,7 +333,7 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
     {
       /* Remove the TCB from the prioritized task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_remove_prioritized(tcb, tasklist);
 
       /* Change the task priority */
 
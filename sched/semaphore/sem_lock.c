@@ -0,0 +1,139 @@
+/****************************************************************************
+ * sched/semaphore/sem_lock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of spinlocks shared by all semaphores.  Must be a power of
+ * two.
+ */
+
+#define SEM_NLOCKS    64
+
+/* sem_t is a few words long, so the low bits of its address carry little
+ * information.
+ */
+
+#define SEM_HASH(sem) \
+  ((((uintptr_t)(sem) >> 4) ^ ((uintptr_t)(sem) >> 10)) & (SEM_NLOCKS - 1))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* sem_t is part of the user ABI and has no room for a lock, so the
+ * semaphores are hashed by address onto this table instead.
+ */
+
+#ifdef CONFIG_MCS_SPINLOCK
+/* All CPUs waiting for a busy semaphore lock would spin on the same cache
+ * line, so queue them instead.  A CPU holds at most one of the locks, and
+ * only with local interrupts disabled, so one queue node per CPU is
+ * enough.
+ */
+
+static mcslock_t g_semlock[SEM_NLOCKS];
+static struct mcs_node_s g_semnode[CONFIG_SMP_NCPUS];
+#else
+static spinlock_t g_semlock[SEM_NLOCKS];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_lock
+ *
+ * Description:
+ *   Disable local interrupts and take the spinlock that protects the count
+ *   of the semaphore.  This is the only protection of the count in the
+ *   paths of nxsem_post(), nxsem_wait() and nxsem_trywait() that do not
+ *   enter the critical section, so every other path that modifies a count
+ *   which may be non-negative must hold it too.
+ *
+ *   The lock must be held only briefly, and never across a context switch
+ *   or while pausing another CPU.
+ *
+ * Input Parameters:
+ *   sem - The semaphore to lock
+ *
+ * Returned Value:
+ *   The interrupt state to pass to nxsem_unlock().
+ *
+ ****************************************************************************/
+
+irqstate_t nxsem_lock(FAR sem_t *sem)
+{
+#ifdef CONFIG_MCS_SPINLOCK
+  irqstate_t flags = up_irq_save();
+
+  /* Pick the node only now that we can't move to another CPU */
+
+  mcs_lock(&g_semlock[SEM_HASH(sem)], &g_semnode[up_cpu_index()]);
+  return flags;
+#else
+  return spin_lock_irqsave(&g_semlock[SEM_HASH(sem)]);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsem_unlock
+ *
+ * Description:
+ *   Release the spinlock taken by nxsem_lock() and restore the interrupt
+ *   state.
+ *
+ * Input Parameters:
+ *   sem   - The semaphore to unlock
+ *   flags - The interrupt state returned by nxsem_lock()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsem_unlock(FAR sem_t *sem, irqstate_t flags)
+{
+#ifdef CONFIG_MCS_SPINLOCK
+  mcs_unlock_irqrestore(&g_semlock[SEM_HASH(sem)],
+                        &g_semnode[up_cpu_index()], flags);
+#else
+  spin_unlock_irqrestore(&g_semlock[SEM_HASH(sem)], flags);
+#endif
+}
+
+#endif /* CONFIG_SMP */
@@ -71,6 +71,7 @@ int nxsem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  irqstate_t lflags;
   int16_t sem_count;
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prioinherit;
@@ -78,6 +79,26 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+  /* If no thread is waiting for the semaphore, there is nothing to do but
+   * to increment the count.  Do that under the semaphore's own lock, the
+   * critical section is only needed to wake up a waiting thread.
+   */
+
+  if (NXSEM_UNTRACKED(sem))
+    {
+      flags = nxsem_lock(sem);
+
+      sem_count = sem->semcount;
+      if (sem_count >= 0 && sem_count < SEM_VALUE_MAX)
+        {
+          sem->semcount = sem_count + 1;
+          nxsem_unlock(sem, flags);
+          return OK;
+        }
+
+      nxsem_unlock(sem, flags);
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -85,18 +106,30 @@ int nxsem_post(FAR sem_t *sem)
 
   flags = enter_critical_section();
 
+  /* The count may still be modified by the paths above, but never while
+   * it is negative.
+   */
+
+  lflags = nxsem_lock(sem);
+
   sem_count = sem->semcount;
 
   /* Check the maximum allowable value */
 
   if (sem_count >= SEM_VALUE_MAX)
     {
+      nxsem_unlock(sem, lflags);
       leave_critical_section(flags);
       return -EOVERFLOW;
     }
 
-  /* Perform the semaphore unlock operation, releasing this task as a
-   * holder then also incrementing the count on the semaphore.
+  sem_count++;
+  sem->semcount = sem_count;
+
+  nxsem_unlock(sem, lflags);
+
+  /* Complete the semaphore unlock operation by releasing this task as a
+   * holder.
    *
    * NOTE:  When semaphores are used for signaling purposes, the holder
    * of the semaphore may not be this thread!  In this case,
@@ -113,8 +146,6 @@ int nxsem_post(FAR sem_t *sem)
    */
 
   nxsem_release_holder(sem);
-  sem_count++;
-  sem->semcount = sem_count;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Don't let any unblocked tasks run until we complete any priority
@@ -76,6 +76,29 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
               up_interrupt_context());
 
+  /* Nothing but the count changes if the semaphore has no holders to
+   * track, so its own lock is enough.
+   */
+
+  if (NXSEM_UNTRACKED(sem))
+    {
+      flags = nxsem_lock(sem);
+
+      if (sem->semcount > 0)
+        {
+          sem->semcount--;
+          rtcb->waitobj = NULL;
+          ret = OK;
+        }
+      else
+        {
+          ret = -EAGAIN;
+        }
+
+      nxsem_unlock(sem, flags);
+      return ret;
+    }
+
   /* The following operations must be performed with interrupts disabled
    * because sem_post() may be called from an interrupt handler.
    */
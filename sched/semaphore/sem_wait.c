@@ -71,6 +71,7 @@ int nxsem_wait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+  irqstate_t lflags;
   bool switch_needed;
   int ret;
 
@@ -79,6 +80,26 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* If the semaphore is available and has no holders to track, take it
+   * without entering the critical section.
+   */
+
+  if (NXSEM_UNTRACKED(sem))
+    {
+      flags = nxsem_lock(sem);
+
+      if (sem->semcount > 0)
+        {
+          sem->semcount--;
+          nxsem_unlock(sem, flags);
+
+          rtcb->waitobj = NULL;
+          return OK;
+        }
+
+      nxsem_unlock(sem, flags);
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -90,11 +111,15 @@ int nxsem_wait(FAR sem_t *sem)
 
   /* Check if the lock is available */
 
+  lflags = nxsem_lock(sem);
+
   if (sem->semcount > 0)
     {
       /* It is, let the task take the semaphore. */
 
       sem->semcount--;
+      nxsem_unlock(sem, lflags);
+
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
@@ -119,6 +144,7 @@ int nxsem_wait(FAR sem_t *sem)
       /* Handle the POSIX semaphore (but don't set the owner yet) */
 
       sem->semcount--;
+      nxsem_unlock(sem, lflags);
 
       /* Save the waited on semaphore in the TCB */
 
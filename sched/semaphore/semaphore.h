@@ -27,12 +27,29 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+#include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/sched.h>
 
 #include <stdint.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Semaphores that do not track their holders for priority inheritance may
+ * be posted and taken without entering the critical section, as long as no
+ * thread has to be woken up or blocked.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define NXSEM_UNTRACKED(sem) \
+     (((sem)->flags & SEM_PRIO_MASK) == SEM_PRIO_NONE)
+#else
+#  define NXSEM_UNTRACKED(sem) true
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -53,6 +70,16 @@ void nxsem_initialize(void);
 #  define nxsem_initialize()
 #endif
 
+/* Protect the count of a semaphore */
+
+#ifdef CONFIG_SMP
+irqstate_t nxsem_lock(FAR sem_t *sem);
+void nxsem_unlock(FAR sem_t *sem, irqstate_t flags);
+#else
+#  define nxsem_lock(sem)          ((void)(sem), up_irq_save())
+#  define nxsem_unlock(sem, flags) up_irq_restore(flags)
+#endif
+
 /* Wake up a thread that is waiting on semaphore */
 
 void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode);
@@ -39,6 +39,14 @@
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_MCS_SPINLOCK
+#  define MCS_ATOMIC(p) ((FAR _Atomic(FAR struct mcs_node_s *) *)(p))
+#endif
+
 #if defined(CONFIG_SPINLOCK) || defined(CONFIG_TICKET_SPINLOCK)
 
 /****************************************************************************
@@ -453,6 +461,143 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 }
 #endif
 
+#ifdef CONFIG_MCS_SPINLOCK
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Append this CPU to the queue of waiters and spin on its own node until
+ *   the previous holder hands the lock over.  Waiters get the lock in FIFO
+ *   order.
+ *
+ *   The node is usually a local variable of the caller.  It must remain
+ *   valid and must not be used for anything else until the matching
+ *   mcs_unlock().
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev;
+
+  node->next = NULL;
+  node->wait = true;
+
+  /* Become the new tail of the queue */
+
+  prev = atomic_exchange(MCS_ATOMIC(lock), node);
+  if (prev != NULL)
+    {
+      /* The lock is held.  Link behind the previous tail and wait for it
+       * to clear our flag.
+       */
+
+      atomic_store(MCS_ATOMIC(&prev->next), node);
+
+      while (atomic_load((FAR atomic_bool *)&node->wait))
+        {
+          SP_DSB();
+          SP_WFE();
+        }
+    }
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Try once to lock the queued spinlock.  Do not wait if the spinlock is
+ *   already locked.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *   node - The queue node of this waiter.
+ *
+ * Returned Value:
+ *   false   - Failure, the spinlock was already locked
+ *   true    - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev = NULL;
+
+  node->next = NULL;
+  node->wait = false;
+
+  if (atomic_compare_exchange_strong(MCS_ATOMIC(lock), &prev, node))
+    {
+      SP_DMB();
+      return true;
+    }
+
+  SP_DSB();
+  return false;
+}
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release a queued spinlock, handing it over to the next waiter if there
+ *   is one.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to unlock.
+ *   node - The node passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR volatile mcslock_t *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *next;
+
+  SP_DMB();
+
+  next = atomic_load(MCS_ATOMIC(&node->next));
+  if (next == NULL)
+    {
+      FAR struct mcs_node_s *tail = node;
+
+      /* If we are still the tail, there is no waiter */
+
+      if (atomic_compare_exchange_strong(MCS_ATOMIC(lock), &tail, NULL))
+        {
+          return;
+        }
+
+      /* Otherwise a waiter has swapped itself in as the tail but has not
+       * linked itself behind us yet.
+       */
+
+      while ((next = atomic_load(MCS_ATOMIC(&node->next))) == NULL)
+        {
+          SP_DSB();
+        }
+    }
+
+  atomic_store((FAR atomic_bool *)&next->wait, false);
+  SP_DSB();
+  SP_SEV();
+}
+
+#endif /* CONFIG_MCS_SPINLOCK */
+
 #ifdef CONFIG_RW_SPINLOCK
 
 /****************************************************************************
@@ -601,9 +746,14 @@ void write_lock(FAR volatile rwlock_t *lock)
 {
   int zero = RW_SP_UNLOCKED;
 
+  /* A failed compare-and-exchange stores the current value in 'zero', so
+   * it must be reset before each attempt.
+   */
+
   while (!atomic_compare_exchange_strong((FAR atomic_int *)lock,
                                          &zero, RW_SP_WRITE_LOCKED))
     {
+      zero = RW_SP_UNLOCKED;
       SP_DSB();
       SP_WFE();
     }
@@ -0,0 +1,251 @@
+/****************************************************************************
+ * sched/semaphore/spinlock_test.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Benchmark driver.  Like mm/mm_gran/mm_gran_test.c, this is not part of
+ * any build.  It is meant to be built as an application of a FLAT SMP
+ * configuration such as sim:smp with CONFIG_MCS_SPINLOCK=y, once with and
+ * once without CONFIG_TICKET_SPINLOCK.
+ *
+ * One thread is pinned to each CPU.  All threads repeatedly take the same
+ * lock, touch a few words of shared data and release the lock.  The
+ * benchmark prints the total number of lock operations per second for
+ * spinlock_t, for the MCS lock, and for rwlock_t with 1 in WRITE_RATIO
+ * writers.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NTHREADS     CONFIG_SMP_NCPUS
+#define DURATION_MS  1000
+#define NDATA        8     /* Words of shared data touched under the lock */
+#define WRITE_RATIO  16    /* One write lock per WRITE_RATIO operations */
+#define PRIORITY     100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum lock_type_e
+{
+  LOCK_SPIN = 0,
+  LOCK_MCS,
+  LOCK_RW,
+  LOCK_NTYPES
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_names[LOCK_NTYPES] =
+{
+#ifdef CONFIG_TICKET_SPINLOCK
+  "spinlock_t (ticket)",
+#else
+  "spinlock_t",
+#endif
+  "mcslock_t",
+  "rwlock_t"
+};
+
+static spinlock_t g_spin = SP_UNLOCKED;
+static mcslock_t g_mcs = MCS_UNLOCKED;
+static rwlock_t g_rw = RW_SP_UNLOCKED;
+
+static volatile uint32_t g_data[NDATA];
+static volatile bool g_start;
+static volatile bool g_stop;
+static uint32_t g_ops[NTHREADS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ms(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void touch(void)
+{
+  int i;
+
+  for (i = 0; i < NDATA; i++)
+    {
+      g_data[i]++;
+    }
+}
+
+static FAR void *thread(FAR void *arg)
+{
+  int type = (int)((uintptr_t)arg >> 8);
+  int cpu = (int)((uintptr_t)arg & 0xff);
+  struct mcs_node_s node;
+  uint32_t ops = 0;
+  volatile uint32_t sum;
+  int i;
+
+  while (!g_start)
+    {
+    }
+
+  while (!g_stop)
+    {
+      switch (type)
+        {
+          case LOCK_SPIN:
+            spin_lock(&g_spin);
+            touch();
+            spin_unlock(&g_spin);
+            break;
+
+          case LOCK_MCS:
+            mcs_lock(&g_mcs, &node);
+            touch();
+            mcs_unlock(&g_mcs, &node);
+            break;
+
+          case LOCK_RW:
+            if (ops % WRITE_RATIO == 0)
+              {
+                write_lock(&g_rw);
+                touch();
+                write_unlock(&g_rw);
+              }
+            else
+              {
+                read_lock(&g_rw);
+                for (sum = 0, i = 0; i < NDATA; i++)
+                  {
+                    sum += g_data[i];
+                  }
+
+                read_unlock(&g_rw);
+              }
+            break;
+        }
+
+      ops++;
+    }
+
+  g_ops[cpu] = ops;
+  return NULL;
+}
+
+static uint64_t run(int type)
+{
+  pthread_t threads[NTHREADS];
+  struct sched_param param;
+  pthread_attr_t attr;
+  cpu_set_t cpuset;
+  uint64_t total = 0;
+  uint64_t start;
+  int i;
+
+  g_start = false;
+  g_stop  = false;
+
+  for (i = 0; i < NTHREADS; i++)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(i, &cpuset);
+
+      pthread_attr_init(&attr);
+      pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+      pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+      param.sched_priority = PRIORITY;
+      pthread_attr_setschedparam(&attr, &param);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+      pthread_create(&threads[i], &attr, thread,
+                     (FAR void *)(((uintptr_t)type << 8) | i));
+      pthread_attr_destroy(&attr);
+    }
+
+  start   = now_ms();
+  g_start = true;
+
+  while (now_ms() - start < DURATION_MS)
+    {
+      usleep(10000);
+    }
+
+  g_stop = true;
+
+  for (i = 0; i < NTHREADS; i++)
+    {
+      pthread_join(threads[i], NULL);
+      total += g_ops[i];
+    }
+
+  return total * 1000 / (now_ms() - start);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ *
+ * Description:
+ *   A simple contention benchmark for the spinlocks
+ *
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct sched_param param;
+  int type;
+
+  /* Run above the threads so that they all start at the same time */
+
+  param.sched_priority = PRIORITY + 1;
+  pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+  for (type = 0; type < LOCK_NTYPES; type++)
+    {
+      printf("%d CPUs, %-20s %llu ops/s\n", NTHREADS, g_names[type],
+             (unsigned long long)run(type));
+    }
+
+  return EXIT_SUCCESS;
+}
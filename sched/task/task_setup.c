@@ -82,7 +82,9 @@ static const char g_noname[] = "<noname>";
 static int nxtask_assign_pid(FAR struct tcb_s *tcb)
 {
   FAR struct tcb_s **pidhash;
+  irqstate_t lock;
   pid_t next_pid;
+  int   npidhash;
   int   hash_ndx;
   void *temp;
   int   i;
@@ -122,10 +124,14 @@ retry:
 
       if (!g_pidhash[hash_ndx])
         {
-          /* Assign this PID to the task */
+          /* Assign this PID to the task.  The critical section excludes
+           * the other writers, g_pidhash_lock excludes the readers.
+           */
 
-          g_pidhash[hash_ndx] = tcb;
           tcb->pid = next_pid;
+          lock = write_lock_irqsave(&g_pidhash_lock);
+          g_pidhash[hash_ndx] = tcb;
+          write_unlock_irqrestore(&g_pidhash_lock, lock);
           g_lastpid = next_pid;
 
           leave_critical_section(flags);
@@ -140,30 +146,36 @@ retry:
    * expand space.
    */
 
-  pidhash = kmm_zalloc(g_npidhash * 2 * sizeof(*pidhash));
+  npidhash = g_npidhash * 2;
+  pidhash  = kmm_zalloc(npidhash * sizeof(*pidhash));
   if (pidhash == NULL)
     {
       leave_critical_section(flags);
       return -ENOMEM;
     }
 
-  g_npidhash *= 2;
-
   /* All original pid and hash_ndx are mismatch,
-   * so we need to rebuild their relationship
+   * so we need to rebuild their relationship.  The readers still use
+   * the original g_pidhash meanwhile.
    */
 
-  for (i = 0; i < g_npidhash / 2; i++)
+  for (i = 0; i < g_npidhash; i++)
     {
-      hash_ndx = PIDHASH(g_pidhash[i]->pid);
+      hash_ndx = g_pidhash[i]->pid & (npidhash - 1);
       DEBUGASSERT(pidhash[hash_ndx] == NULL);
       pidhash[hash_ndx] = g_pidhash[i];
     }
 
-  /* Release resource for original g_pidhash, using new g_pidhash */
+  /* Switch to the new g_pidhash, then release the original one.  No reader
+   * can still use it once the write lock has been taken.
+   */
 
+  lock = write_lock_irqsave(&g_pidhash_lock);
   temp = g_pidhash;
   g_pidhash = pidhash;
+  g_npidhash = npidhash;
+  write_unlock_irqrestore(&g_pidhash_lock, lock);
+
   kmm_free(temp);
 
   /* Let's try every allowable pid again */
@@ -40,99 +40,153 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: wd_cancel
+ * Name: wd_dequeue
  *
  * Description:
- *   This function cancels a currently running watchdog timer. Watchdog
- *   timers may be canceled from the interrupt level.
+ *   Remove an active watchdog from the queue that holds it and mark it
+ *   inactive.
  *
  * Input Parameters:
- *   wdog - ID of the watchdog to cancel.
+ *   wdog - The watchdog to remove.
  *
  * Returned Value:
- *   Zero (OK) is returned on success;  A negated errno value is returned to
- *   indicate the nature of any failure.
+ *   True if the time of the next watchdog event has changed and the
+ *   interval timer needs to be reassessed.
+ *
+ * Assumptions:
+ *   The caller holds the queue of the watchdog (see wd_lock()).
  *
  ****************************************************************************/
 
-int wd_cancel(FAR struct wdog_s *wdog)
+bool wd_dequeue(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  FAR struct wdog_wheel_s *wheel = wd_wheel(wd_getcpu(wdog));
+#ifdef CONFIG_SCHED_TICKLESS
+  clock_t next = wd_wheel_next(wheel);
+#endif
+  bool reassess = false;
+
+  /* Remove the watchdog from its slot in the timing wheel */
+
+  wd_wheel_remove(wheel, wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* The interval timer only needs to be reassessed if this changed the
+   * time of the next event of the wheel.
+   */
+
+  reassess = wheel->nactive == 0 || wd_wheel_next(wheel) != next;
+#endif
+#else
+  FAR sq_queue_t *list = wd_list(wd_getcpu(wdog));
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
-  irqstate_t flags;
-  int ret = -EINVAL;
+  bool reassess = false;
 
-  /* Prohibit timer interactions with the timer queue until the
-   * cancellation is complete
+  /* Search the list for the target FCB.  We can't use sq_rem to do this
+   * because there are additional operations that need to be done.
    */
 
-  flags = enter_critical_section();
+  prev = NULL;
+  curr = (FAR struct wdog_s *)list->head;
 
-  /* Make sure that the watchdog is initialized (non-NULL) and is still
-   * active.
+  while ((curr) && (curr != wdog))
+    {
+      prev = curr;
+      curr = curr->next;
+    }
+
+  /* Check if the watchdog was found in the list.  If not, then an OS
+   * error has occurred because the watchdog is marked active!
+   */
+
+  DEBUGASSERT(curr);
+
+  /* If there is a watchdog in the timer queue after the one that
+   * is being canceled, then it inherits the remaining ticks.
    */
 
-  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+  if (curr->next)
     {
-      /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
-       * to do this because there are additional operations that need to be
-       * done.
-       */
+      curr->next->lag += curr->lag;
+    }
 
-      prev = NULL;
-      curr = (FAR struct wdog_s *)g_wdactivelist.head;
+  /* Now, remove the watchdog from the timer queue */
 
-      while ((curr) && (curr != wdog))
-        {
-          prev = curr;
-          curr = curr->next;
-        }
+  if (prev)
+    {
+      /* Remove the watchdog from mid- or end-of-queue */
 
-      /* Check if the watchdog was found in the list.  If not, then an OS
-       * error has occurred because the watchdog is marked active!
+      sq_remafter((FAR sq_entry_t *)prev, list);
+    }
+  else
+    {
+      /* Remove the watchdog at the head of the queue.  The interval timer
+       * that will generate the next interval event must be reassessed.
        */
 
-      DEBUGASSERT(curr);
+      sq_remfirst(list);
+      reassess = true;
+    }
+#endif
 
-      /* If there is a watchdog in the timer queue after the one that
-       * is being canceled, then it inherits the remaining ticks.
-       */
+  /* Mark the watchdog inactive */
 
-      if (curr->next)
-        {
-          curr->next->lag += curr->lag;
-        }
+  wdog->func = NULL;
+  return reassess;
+}
 
-      /* Now, remove the watchdog from the timer queue */
+/****************************************************************************
+ * Name: wd_cancel
+ *
+ * Description:
+ *   This function cancels a currently running watchdog timer. Watchdog
+ *   timers may be canceled from the interrupt level.
+ *
+ * Input Parameters:
+ *   wdog - ID of the watchdog to cancel.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;  A negated errno value is returned to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
 
-      if (prev)
-        {
-          /* Remove the watchdog from mid- or end-of-queue */
+int wd_cancel(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
 
-          sq_remafter((FAR sq_entry_t *)prev, &g_wdactivelist);
-        }
-      else
-        {
-          /* Remove the watchdog at the head of the queue */
+  if (wdog == NULL)
+    {
+      return ret;
+    }
 
-          sq_remfirst(&g_wdactivelist);
+  /* Prohibit timer interactions with the timer queue until the
+   * cancellation is complete
+   */
 
-          /* Reassess the interval timer that will generate the next
-           * interval event.
-           */
+  flags = wd_lock(wdog);
 
-          nxsched_reassess_timer();
-        }
+  /* Make sure that the watchdog is still active. */
 
-      /* Mark the watchdog inactive */
+  if (WDOG_ISACTIVE(wdog))
+    {
+      /* Remove the watchdog from its queue and reassess the interval timer
+       * that will generate the next interval event if needed.
+       */
 
-      wdog->func = NULL;
+      if (wd_dequeue(wdog))
+        {
+          nxsched_reassess_timer();
+        }
 
       /* Return success */
 
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  wd_unlock(wdog, flags);
   return ret;
 }
@@ -52,21 +52,32 @@
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog)
 {
+  sclock_t delay = 0;
   irqstate_t flags;
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
-  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+  if (wdog == NULL)
     {
+      return 0;
+    }
+
+  flags = wd_lock(wdog);
+  if (WDOG_ISACTIVE(wdog))
+    {
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+      /* The watchdog holds its absolute expiration time */
+
+      delay = wdog->expired - wd_now(wd_wheel(wd_getcpu(wdog))) -
+              wd_elapse();
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
 
       FAR struct wdog_s *curr;
-      sclock_t delay = 0;
 
-      for (curr = (FAR struct wdog_s *)g_wdactivelist.head;
+      for (curr = (FAR struct wdog_s *)wd_list(wd_getcpu(wdog))->head;
            curr != NULL;
            curr = curr->next)
         {
@@ -74,12 +85,12 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
           if (curr == wdog)
             {
               delay -= wd_elapse();
-              leave_critical_section(flags);
-              return delay;
+              break;
             }
         }
+#endif
     }
 
-  leave_critical_section(flags);
-  return 0;
+  wd_unlock(wdog, flags);
+  return delay;
 }
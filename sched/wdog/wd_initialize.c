@@ -32,12 +32,35 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+/* The g_wdwheel data structure holds the active watchdogs hashed by their
+ * expiration time.  When watchdog timers expire, they are removed from the
+ * wheel and the function is called.
+ */
+
+#ifdef CONFIG_WDOG_PERCPU
+struct wdog_wheel_s g_wdwheel[CONFIG_SMP_NCPUS];
+#else
+struct wdog_wheel_s g_wdwheel;
+#endif
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_PERCPU
+sq_queue_t g_wdactivelist[CONFIG_SMP_NCPUS];
+#else
 sq_queue_t g_wdactivelist;
+#endif
+#endif
+
+#ifdef CONFIG_WDOG_PERCPU
+/* The spinlocks protecting the per-CPU watchdog queues */
+
+spinlock_t g_wdlock[CONFIG_SMP_NCPUS];
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
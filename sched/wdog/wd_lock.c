@@ -0,0 +1,140 @@
+/****************************************************************************
+ * sched/wdog/wd_lock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_PERCPU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_lock
+ ****************************************************************************/
+
+irqstate_t wd_lock(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags = up_irq_save();
+  int cpu;
+
+  /* wdog->cpu may change until we hold the lock of that queue, so check it
+   * again once the lock is held.
+   */
+
+  for (; ; )
+    {
+      cpu = wdog->cpu;
+      wd_lock_queue(cpu);
+      if (cpu == wdog->cpu)
+        {
+          return flags;
+        }
+
+      wd_unlock_queue(cpu);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_lock_move
+ ****************************************************************************/
+
+irqstate_t wd_lock_move(FAR struct wdog_s *wdog)
+{
+  irqstate_t flags = up_irq_save();
+  int cpu = this_cpu();
+  int home;
+
+  for (; ; )
+    {
+      home = wdog->cpu;
+      if (home == cpu)
+        {
+          /* The watchdog is already on the queue of this CPU */
+
+          wd_lock_queue(cpu);
+          if (wdog->cpu == cpu)
+            {
+              break;
+            }
+
+          wd_unlock_queue(cpu);
+          continue;
+        }
+
+      /* Take both queue locks in CPU order so that two CPUs moving
+       * watchdogs in opposite directions cannot deadlock.
+       */
+
+      wd_lock_queue(MIN(home, cpu));
+      wd_lock_queue(MAX(home, cpu));
+      if (wdog->cpu == home)
+        {
+          break;
+        }
+
+      wd_unlock_queue(MAX(home, cpu));
+      wd_unlock_queue(MIN(home, cpu));
+    }
+
+  /* Cancel the watchdog on its old queue and hand it over to this CPU.
+   * The caller cannot use wd_cancel() for this since it would take the
+   * queue lock again.
+   */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_dequeue(wdog);
+    }
+
+  if (home != cpu)
+    {
+      wdog->cpu = cpu;
+      wd_unlock_queue(home);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: wd_unlock
+ ****************************************************************************/
+
+void wd_unlock(FAR struct wdog_s *wdog, irqstate_t flags)
+{
+  wd_unlock_queue(wdog->cpu);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_WDOG_PERCPU */
@@ -81,49 +81,88 @@
  *   run. If so, remove the watchdog from the list and execute it.
  *
  * Input Parameters:
- *   None
+ *   cpu - The watchdog queue to process
+ *   now - The time up to which watchdogs are expired (timing wheel only)
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static inline void wd_expiration(void)
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+static inline void wd_expiration(int cpu, clock_t now)
 {
+  FAR struct wdog_wheel_s *wheel = wd_wheel(cpu);
   FAR struct wdog_s *wdog;
   wdentry_t func;
+  wdparm_t arg;
+
+  /* Process all of the watchdogs that have expired by now */
+
+  wd_lock_queue(cpu);
+  while ((wdog = wd_wheel_expire(wheel, now)) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      arg  = wdog->arg;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function without holding the queue */
+
+      wd_unlock_queue(cpu);
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, arg);
+      wd_lock_queue(cpu);
+    }
+
+  wd_unlock_queue(cpu);
+}
+#else
+static inline void wd_expiration(int cpu)
+{
+  FAR sq_queue_t *list = wd_list(cpu);
+  FAR struct wdog_s *wdog;
+  wdentry_t func;
+  wdparm_t arg;
 
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
 
-  while (g_wdactivelist.head &&
-        ((FAR struct wdog_s *)g_wdactivelist.head)->lag <= 0)
+  wd_lock_queue(cpu);
+  while (list->head && ((FAR struct wdog_s *)list->head)->lag <= 0)
     {
       /* Remove the watchdog from the head of the list */
 
-      wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdactivelist);
+      wdog = (FAR struct wdog_s *)sq_remfirst(list);
 
       /* If there is another watchdog behind this one, update its
        * its lag (this shouldn't be necessary).
        */
 
-      if (g_wdactivelist.head)
+      if (list->head)
         {
-          ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
+          ((FAR struct wdog_s *)list->head)->lag += wdog->lag;
         }
 
       /* Indicate that the watchdog is no longer active. */
 
       func = wdog->func;
+      arg  = wdog->arg;
       wdog->func = NULL;
 
-      /* Execute the watchdog function */
+      /* Execute the watchdog function without holding the queue */
 
+      wd_unlock_queue(cpu);
       up_setpicbase(wdog->picbase);
-      CALL_FUNC(func, wdog->arg);
+      CALL_FUNC(func, arg);
+      wd_lock_queue(cpu);
     }
+
+  wd_unlock_queue(cpu);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -168,10 +207,15 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  FAR struct wdog_wheel_s *wheel;
+#else
+  FAR sq_queue_t *list;
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   sclock_t now;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -185,12 +229,17 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
    * NOTE:  There is a race condition here... the caller may receive
    * the watchdog between the time that wd_start is called and
    * the critical section is established.
+   *
+   * With CONFIG_WDOG_PERCPU, wd_lock_move() has already cancelled the
+   * watchdog while moving it to the queue of this CPU.  wd_cancel() must
+   * not be used here since the queue is already locked.  The interval
+   * timer is restarted below once the watchdog is queued again.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock_move(wdog);
   if (WDOG_ISACTIVE(wdog))
     {
-      wd_cancel(wdog);
+      wd_dequeue(wdog);
     }
 
   /* Save the data in the watchdog structure */
@@ -233,9 +282,31 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   nxsched_cancel_timer();
 #endif
 
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  wheel = wd_wheel(wd_getcpu(wdog));
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Restart the time base if there are no other active watchdogs.  The
+   * wheel did not need to follow the time while it was empty.
+   */
+
+  if (wheel->nactive == 0)
+    {
+      g_wdtickbase = clock_systime_ticks();
+      wheel->curr  = g_wdtickbase;
+    }
+#endif
+
+  /* Hash the watchdog into the wheel by its absolute expiration time */
+
+  wdog->expired = wd_now(wheel) + delay;
+  wd_wheel_add(wheel, wdog);
+#else
+  list = wd_list(wd_getcpu(wdog));
+
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
-  if (g_wdactivelist.head == NULL)
+  if (list->head == NULL)
     {
 #ifdef CONFIG_SCHED_TICKLESS
       /* Update clock tickbase */
@@ -245,7 +316,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 
       /* Add the watchdog to the head == tail of the queue. */
 
-      sq_addlast((FAR sq_entry_t *)wdog, &g_wdactivelist);
+      sq_addlast((FAR sq_entry_t *)wdog, list);
     }
 
   /* There are other active watchdogs in the timer queue */
@@ -253,7 +324,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   else
     {
       now = 0;
-      prev = curr = (FAR struct wdog_s *)g_wdactivelist.head;
+      prev = curr = (FAR struct wdog_s *)list->head;
 
       /* Advance to positive time */
 
@@ -286,18 +357,18 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 
           /* Insert the new watchdog in the list */
 
-          if (curr == (FAR struct wdog_s *)g_wdactivelist.head)
+          if (curr == (FAR struct wdog_s *)list->head)
             {
               /* Insert the watchdog at the head of the list */
 
-              sq_addfirst((FAR sq_entry_t *)wdog, &g_wdactivelist);
+              sq_addfirst((FAR sq_entry_t *)wdog, list);
             }
           else
             {
               /* Insert the watchdog in mid- or end-of-queue */
 
               sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)wdog,
-                          &g_wdactivelist);
+                          list);
             }
         }
 
@@ -311,14 +382,14 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
           delay -= now;
           if (!curr->next)
             {
-              sq_addlast((FAR sq_entry_t *)wdog, &g_wdactivelist);
+              sq_addlast((FAR sq_entry_t *)wdog, list);
             }
           else
             {
               next = curr->next;
               next->lag -= delay;
               sq_addafter((FAR sq_entry_t *)curr, (FAR sq_entry_t *)wdog,
-                          &g_wdactivelist);
+                          list);
             }
         }
     }
@@ -326,6 +397,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   /* Put the lag into the watchdog structure and mark it as active. */
 
   wdog->lag = delay;
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Resume the interval timer that will generate the next interval event.
@@ -336,7 +408,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   nxsched_resume_timer();
 #endif
 
-  leave_critical_section(flags);
+  wd_unlock(wdog, flags);
   return OK;
 }
 
@@ -369,17 +441,43 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  FAR struct wdog_wheel_s *wheel = wd_wheel(0);
+  sclock_t delay;
+#else
+  FAR sq_queue_t *list = wd_list(0);
   FAR struct wdog_s *wdog;
   unsigned int ret;
   int decr;
+#endif
 
   /* Update clock tickbase */
 
   g_wdtickbase += ticks;
 
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+  /* Process the watchdogs that have expired by now */
+
+  if (!noswitches)
+    {
+      wd_expiration(0, g_wdtickbase);
+    }
+
+  /* Return the delay for the next event of the wheel.  This is never
+   * later than the next watchdog to expire.
+   */
+
+  if (wheel->nactive == 0)
+    {
+      return 0;
+    }
+
+  delay = wheel->curr + wd_wheel_next(wheel) - g_wdtickbase;
+  return MAX(delay, 1);
+#else
   /* Check if there are any active watchdogs to process */
 
-  wdog = (FAR struct wdog_s *)g_wdactivelist.head;
+  wdog = (FAR struct wdog_s *)list->head;
   while (wdog != NULL && ticks > 0)
     {
       /* Decrement the lag for this watchdog. */
@@ -398,33 +496,53 @@ unsigned int wd_timer(int ticks, bool noswitches)
 
   if (!noswitches)
     {
-      wd_expiration();
+      wd_expiration(0);
     }
 
   /* Return the delay for the next watchdog to expire */
 
-  ret = g_wdactivelist.head ?
-        MAX(((FAR struct wdog_s *)g_wdactivelist.head)->lag, 1) : 0;
+  ret = list->head ? MAX(((FAR struct wdog_s *)list->head)->lag, 1) : 0;
 
   /* Return the delay for the next watchdog to expire */
 
   return ret;
+#endif
 }
 
 #else
 void wd_timer(void)
 {
-  /* Check if there are any active watchdogs to process */
+  int cpu;
 
-  if (g_wdactivelist.head)
+  /* The system timer only interrupts one CPU, process the watchdog queues
+   * of all of the CPUs here.
+   */
+
+  for (cpu = 0; cpu < WDOG_NQUEUES; cpu++)
     {
-      /* There are.  Decrement the lag counter */
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+      /* Advance the wheel by one tick and process the expired watchdogs */
 
-      --(((FAR struct wdog_s *)g_wdactivelist.head)->lag);
+      wd_expiration(cpu, wd_wheel(cpu)->curr + 1);
+#else
+      FAR sq_queue_t *list = wd_list(cpu);
+
+      /* Check if there are any active watchdogs to process */
+
+      wd_lock_queue(cpu);
+      if (list->head)
+        {
+          /* There are.  Decrement the lag counter */
+
+          --(((FAR struct wdog_s *)list->head)->lag);
+        }
+
+      wd_unlock_queue(cpu);
 
       /* Check if the watchdog at the head of the list is ready to run */
 
-      wd_expiration();
+      wd_expiration(cpu);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_TICKLESS */
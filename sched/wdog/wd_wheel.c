@@ -0,0 +1,309 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Hash a watchdog into the wheel slot matching its expiration time,
+ *   relative to the last processed tick.  Watchdogs that are already due
+ *   go into the current slot of the lowest level.  Watchdogs beyond the
+ *   range of the wheel are parked in the top level and reinserted when
+ *   that slot is cascaded.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_wheel_s *wheel,
+                            FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **head;
+  clock_t expired = wdog->expired;
+  sclock_t delta = expired - wheel->curr;
+  int level;
+  int idx;
+
+  if (delta < 0)
+    {
+      delta   = 0;
+      expired = wheel->curr;
+    }
+  else if (delta >= WDOG_WHEEL_RANGE)
+    {
+      delta   = WDOG_WHEEL_RANGE - 1;
+      expired = wheel->curr + delta;
+    }
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS - 1; level++)
+    {
+      if (delta < ((sclock_t)1 << ((level + 1) * WDOG_WHEEL_BITS)))
+        {
+          break;
+        }
+    }
+
+  idx  = (expired >> (level * WDOG_WHEEL_BITS)) & WDOG_WHEEL_MASK;
+  head = &wheel->slot[level][idx];
+
+  wdog->next = *head;
+  if (*head != NULL)
+    {
+      (*head)->pprev = &wdog->next;
+    }
+
+  wdog->pprev = head;
+  *head = wdog;
+
+  wheel->pending[level] |= (uint32_t)1 << idx;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Unlink a watchdog from its slot and update the bitmap of non-empty
+ *   slots if that slot became empty.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_unlink(FAR struct wdog_wheel_s *wheel,
+                            FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **pprev = wdog->pprev;
+  uintptr_t offset;
+
+  *pprev = wdog->next;
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = pprev;
+    }
+  else
+    {
+      /* This was the last watchdog of the list.  If it was also the
+       * first, then pprev points to the slot head and the slot is empty
+       * now.
+       */
+
+      offset = (uintptr_t)pprev - (uintptr_t)&wheel->slot[0][0];
+      if (offset < sizeof(wheel->slot))
+        {
+          offset /= sizeof(wheel->slot[0][0]);
+          wheel->pending[offset / WDOG_WHEEL_SLOTS] &=
+            ~((uint32_t)1 << (offset % WDOG_WHEEL_SLOTS));
+        }
+    }
+
+  wdog->next  = NULL;
+  wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Called each time wheel->curr is advanced.  When the lower level
+ *   wraps around, the next slot of each higher level is redistributed into
+ *   the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(FAR struct wdog_wheel_s *wheel)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int level;
+  int idx;
+
+  for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      if (((wheel->curr >> ((level - 1) * WDOG_WHEEL_BITS)) &
+           WDOG_WHEEL_MASK) != 0)
+        {
+          break;
+        }
+
+      idx  = (wheel->curr >> (level * WDOG_WHEEL_BITS)) &
+             WDOG_WHEEL_MASK;
+      wdog = wheel->slot[level][idx];
+
+      wheel->slot[level][idx] = NULL;
+      wheel->pending[level] &= ~((uint32_t)1 << idx);
+
+      while (wdog != NULL)
+        {
+          next = wdog->next;
+          wd_wheel_insert(wheel, wdog);
+          wdog = next;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_wheel_s *wheel, FAR struct wdog_s *wdog)
+{
+  wd_wheel_insert(wheel, wdog);
+  wheel->nactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_wheel_s *wheel,
+                     FAR struct wdog_s *wdog)
+{
+  DEBUGASSERT(wdog->pprev != NULL && wheel->nactive > 0);
+
+  wd_wheel_unlink(wheel, wdog);
+  wheel->nactive--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(FAR struct wdog_wheel_s *wheel,
+                                   clock_t now)
+{
+  FAR struct wdog_s *wdog;
+  clock_t next;
+
+  for (; ; )
+    {
+      /* Nothing to do if the wheel is empty, just catch up with 'now' */
+
+      if (wheel->nactive == 0)
+        {
+          wheel->curr = now;
+          return NULL;
+        }
+
+      /* Anything left in the current slot of the lowest level is due */
+
+      wdog = wheel->slot[0][wheel->curr & WDOG_WHEEL_MASK];
+      if (wdog != NULL)
+        {
+          wd_wheel_remove(wheel, wdog);
+          return wdog;
+        }
+
+      if ((sclock_t)(now - wheel->curr) <= 0)
+        {
+          return NULL;
+        }
+
+      /* Skip directly to the next tick that has an expiration or a
+       * cascade of a non-empty slot, but not beyond 'now'.
+       */
+
+      next = wheel->curr + wd_wheel_next(wheel);
+      if ((sclock_t)(next - now) > 0)
+        {
+          next = now;
+        }
+
+      wheel->curr = next;
+      wd_wheel_cascade(wheel);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ ****************************************************************************/
+
+clock_t wd_wheel_next(FAR struct wdog_wheel_s *wheel)
+{
+  clock_t curr = wheel->curr;
+  clock_t next = WDOG_WHEEL_RANGE;
+  clock_t base;
+  clock_t delay;
+  uint32_t pending;
+  int shift;
+  int level;
+  int idx;
+
+  DEBUGASSERT(wheel->nactive > 0);
+
+  if (wheel->slot[0][curr & WDOG_WHEEL_MASK] != NULL)
+    {
+      return 0;
+    }
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      pending = wheel->pending[level];
+      if (pending == 0)
+        {
+          continue;
+        }
+
+      /* The first tick after curr at which this level advances and the
+       * slot that it advances to.
+       */
+
+      shift = level * WDOG_WHEEL_BITS;
+      base  = ((curr >> shift) + 1) << shift;
+      idx   = (base >> shift) & WDOG_WHEEL_MASK;
+
+      /* Rotate the bitmap so that bit 0 corresponds to that slot */
+
+      if (idx != 0)
+        {
+          pending = (pending >> idx) |
+                    (pending << (WDOG_WHEEL_SLOTS - idx));
+        }
+
+      delay = base - curr + ((clock_t)(ffs((int)pending) - 1) << shift);
+      if (delay < next)
+        {
+          next = delay;
+        }
+    }
+
+  return next;
+}
+
+#endif /* CONFIG_WDOG_TIMINGWHEEL */
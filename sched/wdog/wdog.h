@@ -32,7 +32,9 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
 /****************************************************************************
@@ -56,6 +58,75 @@
 #  define wd_elapse() (0)
 #endif
 
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+
+/* Geometry of the hierarchical timing wheel.  Each level has
+ * WDOG_WHEEL_SLOTS slots and each slot of level n covers
+ * WDOG_WHEEL_SLOTS^n ticks.  The bitmap of non-empty slots in a level is
+ * held in one uint32_t.
+ */
+
+#  define WDOG_WHEEL_BITS     5
+#  define WDOG_WHEEL_SLOTS    (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK     (WDOG_WHEEL_SLOTS - 1)
+#  define WDOG_WHEEL_LEVELS   CONFIG_WDOG_TIMINGWHEEL_LEVELS
+#  define WDOG_WHEEL_RANGE    ((sclock_t)1 << \
+                               (WDOG_WHEEL_BITS * WDOG_WHEEL_LEVELS))
+
+/****************************************************************************
+ * Name: wd_now
+ *
+ * Description:
+ *   The time origin used to convert the relative delay of a new watchdog
+ *   into its absolute expiration time.
+ *
+ ****************************************************************************/
+
+#  ifdef CONFIG_SCHED_TICKLESS
+#    define wd_now(wheel) (g_wdtickbase)
+#  else
+#    define wd_now(wheel) ((wheel)->curr)
+#  endif
+#endif /* CONFIG_WDOG_TIMINGWHEEL */
+
+/* With CONFIG_WDOG_PERCPU, each CPU arms watchdogs on its own queue that
+ * is protected by its own spinlock instead of the global critical section.
+ * wdog->cpu records the queue that a watchdog was last started on.
+ */
+
+#ifdef CONFIG_WDOG_PERCPU
+#  define WDOG_NQUEUES          CONFIG_SMP_NCPUS
+#  define wd_list(cpu)          (&g_wdactivelist[cpu])
+#  define wd_wheel(cpu)         (&g_wdwheel[cpu])
+#  define wd_getcpu(wdog)       ((wdog)->cpu)
+#  define wd_lock_queue(cpu)    spin_lock(&g_wdlock[cpu])
+#  define wd_unlock_queue(cpu)  spin_unlock(&g_wdlock[cpu])
+#else
+#  define WDOG_NQUEUES          1
+#  define wd_list(cpu)          (&g_wdactivelist)
+#  define wd_wheel(cpu)         (&g_wdwheel)
+#  define wd_getcpu(wdog)       (0)
+#  define wd_lock_queue(cpu)
+#  define wd_unlock_queue(cpu)
+#  define wd_lock(wdog)         enter_critical_section()
+#  define wd_lock_move(wdog)    enter_critical_section()
+#  define wd_unlock(wdog, f)    leave_critical_section(f)
+#endif
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+struct wdog_wheel_s
+{
+  clock_t      curr;                         /* Last tick processed */
+  unsigned int nactive;                      /* Number of active wdogs */
+  uint32_t     pending[WDOG_WHEEL_LEVELS];   /* Bitmaps of non-empty slots */
+  FAR struct wdog_s *slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -68,12 +139,35 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+/* The g_wdwheel data structure holds the active watchdogs hashed by their
+ * expiration time.  When watchdog timers expire, they are removed from the
+ * wheel and the function is called.
+ */
+
+#ifdef CONFIG_WDOG_PERCPU
+extern struct wdog_wheel_s g_wdwheel[CONFIG_SMP_NCPUS];
+#else
+extern struct wdog_wheel_s g_wdwheel;
+#endif
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_PERCPU
+extern sq_queue_t g_wdactivelist[CONFIG_SMP_NCPUS];
+#else
 extern sq_queue_t g_wdactivelist;
+#endif
+#endif
+
+#ifdef CONFIG_WDOG_PERCPU
+/* The spinlocks protecting the per-CPU watchdog queues */
+
+extern spinlock_t g_wdlock[CONFIG_SMP_NCPUS];
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -119,6 +213,171 @@ unsigned int wd_timer(int ticks, bool noswitches);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: wd_dequeue
+ *
+ * Description:
+ *   Remove an active watchdog from the queue that holds it and mark it
+ *   inactive.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove.
+ *
+ * Returned Value:
+ *   True if the time of the next watchdog event has changed and the
+ *   interval timer needs to be reassessed.
+ *
+ * Assumptions:
+ *   The caller holds the queue of the watchdog (see wd_lock()).
+ *
+ ****************************************************************************/
+
+bool wd_dequeue(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_lock
+ *
+ * Description:
+ *   Disable local interrupts and take the lock of the queue that holds the
+ *   watchdog.  wdog->cpu cannot change until wd_unlock() is called.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to lock.
+ *
+ * Returned Value:
+ *   The interrupt state to be passed to wd_unlock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_PERCPU
+irqstate_t wd_lock(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_lock_move
+ *
+ * Description:
+ *   Like wd_lock(), but also move the watchdog to the queue of the current
+ *   CPU.  The watchdog is cancelled if it is still active.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to lock.
+ *
+ * Returned Value:
+ *   The interrupt state to be passed to wd_unlock().
+ *
+ ****************************************************************************/
+
+irqstate_t wd_lock_move(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_unlock
+ *
+ * Description:
+ *   Release the lock taken by wd_lock() or wd_lock_move().
+ *
+ * Input Parameters:
+ *   wdog  - The locked watchdog.
+ *   flags - The interrupt state returned by wd_lock().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void wd_unlock(FAR struct wdog_s *wdog, irqstate_t flags);
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Insert a watchdog into the timing wheel.  wdog->expired must already
+ *   hold the absolute expiration time of the watchdog.
+ *
+ * Input Parameters:
+ *   wheel - The timing wheel to use.
+ *   wdog  - The watchdog to insert.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMINGWHEEL
+void wd_wheel_add(FAR struct wdog_wheel_s *wheel, FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timing wheel in constant time.
+ *
+ * Input Parameters:
+ *   wheel - The timing wheel holding the watchdog.
+ *   wdog  - The watchdog to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_wheel_s *wheel,
+                     FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the timing wheel towards the time 'now' and remove the next
+ *   watchdog that has expired by then.  Slots and cascades that have
+ *   nothing to do are skipped using the bitmaps of non-empty slots.
+ *
+ * Input Parameters:
+ *   wheel - The timing wheel to advance.
+ *   now   - The time up to which watchdogs are expired.
+ *
+ * Returned Value:
+ *   The expired watchdog, already removed from the wheel, or NULL if no
+ *   more watchdogs expire at or before 'now'.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(FAR struct wdog_wheel_s *wheel,
+                                   clock_t now);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from wheel->curr to the next event of the
+ *   wheel: either the expiration of a watchdog in the lowest level or the
+ *   cascade of a non-empty slot of a higher level.  The latter may be
+ *   earlier than the actual expiration of the watchdogs in that slot.
+ *
+ * Input Parameters:
+ *   wheel - The timing wheel to inspect.
+ *
+ * Returned Value:
+ *   The number of ticks to the next event.  Zero is returned if there are
+ *   already expired watchdogs waiting to be processed.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled and at least one active watchdog.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next(FAR struct wdog_wheel_s *wheel);
+#endif
+
 /****************************************************************************
  * Name: wd_recover
  *
@@ -90,7 +90,8 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, int nthread,
         }
       else
         {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          dq_rem((FAR dq_entry_t *)work,
+                 &wqueue->queue[work_qndx(work)].q);
         }
 
       work->worker = NULL;
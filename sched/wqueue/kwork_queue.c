@@ -39,26 +39,47 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
-  do \
-    { \
-      int sem_count; \
-      dq_addlast((FAR dq_entry_t *)(work), &(wqueue).q); \
-      nxsem_get_value(&(wqueue).sem, &sem_count); \
-      if (sem_count < 0) /* There are threads waiting for sem. */ \
-        { \
-          nxsem_post(&(wqueue).sem); \
-        } \
-    } \
-  while (0)
-
 /****************************************************************************
- * Private Functions
+ * Name: queue_work
+ *
+ * Description:
+ *   Add the work to the queue of its CPU and wake up a worker thread of
+ *   that CPU if one is waiting.  Otherwise, wake up a waiting worker of
+ *   another CPU, which will then steal the work.  If no worker is waiting,
+ *   the first one to finish its current work will find it.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
  ****************************************************************************/
 
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+  FAR struct kwork_queue_s *queue;
+  int semcount;
+  int ndx;
+  int i;
+
+  ndx = work_qndx(work);
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->queue[ndx].q);
+
+  for (i = 0; i < KWORK_NQUEUES; i++)
+    {
+      queue = &wqueue->queue[(ndx + i) % KWORK_NQUEUES];
+
+      nxsem_get_value(&queue->sem, &semcount);
+      if (semcount < 0) /* There are threads waiting for sem. */
+        {
+          nxsem_post(&queue->sem);
+          break;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: hp_work_timer_expiry
  ****************************************************************************/
@@ -67,7 +88,8 @@
 static void hp_work_timer_expiry(wdparm_t arg)
 {
   irqstate_t flags = enter_critical_section();
-  queue_work(g_hpwork, arg);
+  queue_work((FAR struct kwork_wqueue_s *)&g_hpwork,
+             (FAR struct work_s *)arg);
   leave_critical_section(flags);
 }
 #endif
@@ -80,47 +102,22 @@ static void hp_work_timer_expiry(wdparm_t arg)
 static void lp_work_timer_expiry(wdparm_t arg)
 {
   irqstate_t flags = enter_critical_section();
-  queue_work(g_lpwork, arg);
+  queue_work((FAR struct kwork_wqueue_s *)&g_lpwork,
+             (FAR struct work_s *)arg);
   leave_critical_section(flags);
 }
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: work_queue
+ * Name: work_qqueue
  *
  * Description:
- *   Queue kernel-mode work to be performed at a later time.  All queued
- *   work will be performed on the worker thread of execution (not the
- *   caller's).
- *
- *   The work structure is allocated and must be initialized to all zero by
- *   the caller.  Otherwise, the work structure is completely managed by the
- *   work queue logic.  The caller should never modify the contents of the
- *   work queue structure directly.  If work_queue() is called before the
- *   previous work has been performed and removed from the queue, then any
- *   pending work will be canceled and lost.
- *
- * Input Parameters:
- *   qid    - The work queue ID (index)
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will be
- *            invoked on the worker thread of execution.
- *   arg    - The argument that will be passed to the worker callback when
- *            int is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
- *
- * Returned Value:
- *   Zero on success, a negated errno on failure
+ *   Queue the work on the queue with index 'ndx' of the work queue 'qid'.
  *
  ****************************************************************************/
 
-int work_queue(int qid, FAR struct work_s *work, worker_t worker,
-               FAR void *arg, clock_t delay)
+static int work_qqueue(int qid, FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t delay, int ndx)
 {
   irqstate_t flags;
   int ret = OK;
@@ -142,6 +139,9 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg = arg;                 /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work->cpu = ndx;                 /* The queue to add the work to */
+#endif
 
   /* Queue the new work */
 
@@ -152,7 +152,7 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
       if (!delay)
         {
-          queue_work(g_hpwork, work);
+          queue_work((FAR struct kwork_wqueue_s *)&g_hpwork, work);
         }
       else
         {
@@ -169,7 +169,7 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
       if (!delay)
         {
-          queue_work(g_lpwork, work);
+          queue_work((FAR struct kwork_wqueue_s *)&g_lpwork, work);
         }
       else
         {
@@ -188,4 +188,90 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue
+ *
+ * Description:
+ *   Queue kernel-mode work to be performed at a later time.  All queued
+ *   work will be performed on the worker thread of execution (not the
+ *   caller's).
+ *
+ *   The work structure is allocated and must be initialized to all zero by
+ *   the caller.  Otherwise, the work structure is completely managed by the
+ *   work queue logic.  The caller should never modify the contents of the
+ *   work queue structure directly.  If work_queue() is called before the
+ *   previous work has been performed and removed from the queue, then any
+ *   pending work will be canceled and lost.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue(int qid, FAR struct work_s *work, worker_t worker,
+               FAR void *arg, clock_t delay)
+{
+  /* Prefer the worker threads of the calling CPU, which probably has the
+   * data of the work in its cache.
+   */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  return work_qqueue(qid, work, worker, arg, delay, up_cpu_index());
+#else
+  return work_qqueue(qid, work, worker, arg, delay, 0);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work like work_queue(), but on the queue of the specified CPU
+ *   instead of the queue of the calling CPU.  The work is performed by a
+ *   worker thread of that CPU unless all of them are busy and a worker of
+ *   another CPU is idle.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   cpu    - The CPU whose worker threads should perform the work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_cpu(int qid, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, int cpu)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  return work_qqueue(qid, work, worker, arg, delay, cpu);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
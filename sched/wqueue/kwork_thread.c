@@ -80,8 +80,12 @@
 
 struct hp_wqueue_s g_hpwork =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
+  {
+    {
+      {NULL, NULL},
+      SEM_INITIALIZER(0),
+    },
+  },
 };
 
 #endif /* CONFIG_SCHED_HPWORK */
@@ -91,8 +95,12 @@ struct hp_wqueue_s g_hpwork =
 
 struct lp_wqueue_s g_lpwork =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
+  {
+    {
+      {NULL, NULL},
+      SEM_INITIALIZER(0),
+    },
+  },
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
@@ -101,6 +109,64 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_steal
+ *
+ * Description:
+ *   Called by a worker thread when the queue of its own CPU is empty.  Move
+ *   the older half of the pending work of the first other CPU that has any
+ *   to the queue of this worker, so that the workers of both CPUs can
+ *   proceed without stealing from each other for every entry.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   ndx    - The index of the queue of the calling worker
+ *
+ * Returned Value:
+ *   true if any work was moved to the queue 'ndx'.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static bool work_steal(FAR struct kwork_wqueue_s *wqueue, int ndx)
+{
+  FAR struct kwork_queue_s *victim;
+  FAR struct work_s *work;
+  FAR dq_entry_t *entry;
+  int count;
+  int i;
+
+  for (i = 1; i < KWORK_NQUEUES; i++)
+    {
+      victim = &wqueue->queue[(ndx + i) % KWORK_NQUEUES];
+
+      count = 0;
+      for (entry = dq_peek(&victim->q); entry != NULL;
+           entry = dq_next(entry))
+        {
+          count++;
+        }
+
+      if (count > 0)
+        {
+          for (count = (count + 1) / 2; count > 0; count--)
+            {
+              work = (FAR struct work_s *)dq_remfirst(&victim->q);
+              work->cpu = ndx;
+              dq_addlast((FAR dq_entry_t *)work, &wqueue->queue[ndx].q);
+            }
+
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -126,12 +192,14 @@ struct lp_wqueue_s g_lpwork =
 static int work_thread(int argc, FAR char *argv[])
 {
   FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kwork_queue_s *queue;
   FAR struct kworker_s *kworker;
   FAR struct work_s *work;
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
   int semcount;
+  int ndx;
 
   /* Get the handle from argv */
 
@@ -140,6 +208,11 @@ static int work_thread(int argc, FAR char *argv[])
   kworker = (FAR struct kworker_s *)
             ((uintptr_t)strtoul(argv[2], NULL, 0));
 
+  /* The worker threads are distributed over the queues of the CPUs */
+
+  ndx   = (kworker - wqueue->worker) % KWORK_NQUEUES;
+  queue = &wqueue->queue[ndx];
+
   flags = enter_critical_section();
 
   /* Loop forever */
@@ -153,7 +226,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = (FAR struct work_s *)dq_remfirst(&queue->q)) != NULL)
         {
           if (work->worker == NULL)
             {
@@ -199,12 +272,21 @@ static int work_thread(int argc, FAR char *argv[])
             }
         }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Help the workers of the other CPUs before going to sleep */
+
+      if (work_steal(wqueue, ndx))
+        {
+          continue;
+        }
+#endif
+
       /* Then process queued work.  work_process will not return until: (1)
        * there is no further work in the work queue, and (2) semaphore is
        * posted.
        */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+      nxsem_wait_uninterruptible(&queue->sem);
     }
 
   leave_critical_section(flags);
@@ -238,6 +320,9 @@ static int work_thread_create(FAR const char *name, int priority,
   FAR char *argv[3];
   char arg0[32];
   char arg1[32];
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  cpu_set_t cpuset;
+#endif
   int wndx;
   int pid;
 
@@ -269,6 +354,14 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Keep the worker on the CPU of its queue (see work_thread()) */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wndx % KWORK_NQUEUES, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+#endif
     }
 
   sched_unlock();
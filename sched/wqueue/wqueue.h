@@ -44,6 +44,19 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of queues of pending work in each work queue.  With
+ * CONFIG_SCHED_WORKQUEUE_PERCPU, there is one for each CPU and the worker
+ * threads are distributed over them.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define KWORK_NQUEUES CONFIG_SMP_NCPUS
+#  define work_qndx(work) ((work)->cpu)
+#else
+#  define KWORK_NQUEUES 1
+#  define work_qndx(work) 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -57,12 +70,23 @@ struct kworker_s
   sem_t             wait;      /* Sync waiting for worker done */
 };
 
+/* This represents the pending work of one CPU and the workers waiting
+ * for it.
+ */
+
+struct kwork_queue_s
+{
+  struct dq_queue_s q;         /* The queue of pending work */
+  sem_t             sem;       /* The counting semaphore of the queue */
+};
+
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
-  sem_t             sem;       /* The counting semaphore of the wqueue */
+  /* The queues of pending work */
+
+  struct kwork_queue_s queue[KWORK_NQUEUES];
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -73,8 +97,9 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
-  sem_t             sem;       /* The counting semaphore of the wqueue */
+  /* The queues of pending work */
+
+  struct kwork_queue_s queue[KWORK_NQUEUES];
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -89,8 +114,9 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
-  sem_t             sem;       /* The counting semaphore of the wqueue */
+  /* The queues of pending work */
+
+  struct kwork_queue_s queue[KWORK_NQUEUES];
 
   /* Describes each thread in the low priority queue's thread pool */
 
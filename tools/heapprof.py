@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+# tools/heapprof.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+import argparse
+import math
+import os
+import re
+
+program_description = """
+This program summarizes a heap profile read from /proc/heapprof.
+It estimates the real usage of every call site from the sampled
+allocations and prints the call sites using the most memory, or
+folded stacks for flamegraph.pl.
+
+With --base, the allocation rate of every call site between the
+two profiles is printed too.  The raw file can also be read by
+pprof as a legacy heap profile.
+"""
+
+header_re = re.compile(r"heap profile: .*@ heap_v2/(\d+)")
+elapsed_re = re.compile(r"# elapsed_ms (\d+) dropped (\d+)")
+peak_re = re.compile(r"# peak (\d+)")
+site_re = re.compile(r"(\d+): (\d+) \[(\d+): (\d+)\] @((?: 0x[0-9a-fA-F]+)+)")
+
+
+class site:
+    def __init__(self, match, peak):
+        self.inuse_count = int(match.group(1))
+        self.inuse_bytes = int(match.group(2))
+        self.alloc_count = int(match.group(3))
+        self.alloc_bytes = int(match.group(4))
+        self.peak_bytes = peak
+        self.stack = tuple(match.group(5).split())
+        self.rate = 0
+
+    def unsample(self, rate):
+        # A sampled allocation of the average size stands for this
+        # many allocations, as in pprof
+
+        if rate == 0 or self.alloc_count == 0:
+            return
+
+        avg = self.alloc_bytes / self.alloc_count
+        scale = 1 / (1 - math.exp(-avg / rate))
+        self.inuse_count = round(self.inuse_count * scale)
+        self.inuse_bytes = round(self.inuse_bytes * scale)
+        self.alloc_count = round(self.alloc_count * scale)
+        self.alloc_bytes = round(self.alloc_bytes * scale)
+        self.peak_bytes = round(self.peak_bytes * scale)
+
+
+class profile:
+    def __init__(self, path):
+        self.rate = 0
+        self.elapsed_ms = 0
+        self.dropped = 0
+        self.sites = {}
+
+        peak = 0
+        with open(path, "r") as f:
+            for line in f:
+                match = header_re.search(line)
+                if match:
+                    self.rate = int(match.group(1))
+                    continue
+
+                match = elapsed_re.search(line)
+                if match:
+                    self.elapsed_ms = int(match.group(1))
+                    self.dropped = int(match.group(2))
+                    continue
+
+                match = peak_re.search(line)
+                if match:
+                    peak = int(match.group(1))
+                    continue
+
+                match = site_re.search(line)
+                if match:
+                    s = site(match, peak)
+                    s.unsample(self.rate)
+                    self.sites[s.stack] = s
+                    peak = 0
+
+
+def addr2line(args, stack):
+    if args.elffile == "":
+        return list(stack)
+
+    pipe = os.popen(
+        "%saddr2line -Cfe %s %s" % (args.prefix, args.elffile, " ".join(stack)),
+        "r",
+    )
+    lines = pipe.read().splitlines()
+    pipe.close()
+
+    # addr2line prints the function and the location of every address
+
+    return [
+        "%s (%s)" % (lines[i], os.path.basename(lines[i + 1]))
+        for i in range(0, len(lines) - 1, 2)
+    ]
+
+
+def print_top(args, prof, sites):
+    print(
+        "rate %d, %d ms, %d samples dropped"
+        % (prof.rate, prof.elapsed_ms, prof.dropped)
+    )
+    print("%10s %8s %10s %10s %10s" % ("inuse", "count", "alloc", "peak", "B/s"))
+
+    for s in sites[: args.top]:
+        print(
+            "%10d %8d %10d %10d %10d"
+            % (s.inuse_bytes, s.inuse_count, s.alloc_bytes, s.peak_bytes, s.rate)
+        )
+        for frame in addr2line(args, s.stack):
+            print("    %s" % frame)
+
+
+def print_folded(args, sites):
+    for s in sites:
+        frames = addr2line(args, s.stack)
+        frames.reverse()
+        print("%s %d" % (";".join(frames), s.inuse_bytes))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=program_description, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("file", help="heap profile read from /proc/heapprof")
+    parser.add_argument(
+        "-b", "--base", help="an earlier heap profile, to compute allocation rates"
+    )
+    parser.add_argument("-e", "--elffile", default="", help="elf file to symbolize")
+    parser.add_argument("-p", "--prefix", default="", help="addr2line program prefix")
+    parser.add_argument(
+        "-n", "--top", type=int, default=20, help="number of call sites to print"
+    )
+    parser.add_argument(
+        "-f", "--folded", action="store_true", help="print folded stacks of inuse bytes"
+    )
+
+    args = parser.parse_args()
+    prof = profile(args.file)
+
+    if args.base:
+        base = profile(args.base)
+        elapsed = prof.elapsed_ms - base.elapsed_ms
+        if elapsed > 0:
+            for stack, s in prof.sites.items():
+                old = base.sites.get(stack)
+                delta = s.alloc_bytes - (old.alloc_bytes if old else 0)
+                s.rate = delta * 1000 // elapsed
+
+    sites = sorted(
+        prof.sites.values(), key=lambda s: (s.inuse_bytes, s.rate), reverse=True
+    )
+
+    if args.folded:
+        print_folded(args, sites)
+    else:
+        print_top(args, prof, sites)
@@ -362,8 +362,8 @@ static void btnet_l2cap_receive(FAR struct bt_conn_s *conn,
   frame->io_offset = (unsigned int)
     ((uintptr_t)buf->data - (uintptr_t)frame->io_data);
 
-  DEBUGASSERT(frame->io_len <= CONFIG_IOB_BUFSIZE);
-  DEBUGASSERT(frame->io_offset < CONFIG_IOB_BUFSIZE);
+  DEBUGASSERT(frame->io_len <= IOB_BUFSIZE(frame));
+  DEBUGASSERT(frame->io_offset < IOB_BUFSIZE(frame));
 
   /* Construct the frame meta data.
    * REVISIT: Where do we get the channel number?
@@ -525,7 +525,7 @@ static void btnet_hci_received(FAR struct bt_buf_s *buf, FAR void *context)
   frame->io_pktlen = buf->len + frame->io_offset;
   frame->io_offset = 0;
 
-  DEBUGASSERT(frame->io_len <= CONFIG_IOB_BUFSIZE);
+  DEBUGASSERT(frame->io_len <= IOB_BUFSIZE(frame));
 
   /* Write H4 header */
 